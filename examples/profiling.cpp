@@ -1,5 +1,3 @@
-#define PROFILELOG
-
 #include "baltazar/dag.hpp"
 #include "baltazar/parallel.hpp"
 #include "baltazar/thread_pool.hpp"
@@ -109,7 +107,8 @@ int main() {
 
   // Define profiler
   // Note:
-  // Important to define PROFILELOG macro as is in the first line of this file!
+  // Profiling is switched at runtime, profiler can be turned on and off with
+  // runner.getProfiler().turnOn() and turnOff() while graph is running.
   std::string file_path = "temp/output_log.txt";
   fs::path dir_path = fs::path(file_path).parent_path();
 
@@ -2,18 +2,40 @@
 #define BALTAZAR_DAG_API
 
 #include "../../src/dag/dag.hpp"
+#include "../../src/dag/dynamic_dag.hpp"
+#include "../../src/dag/edge_map.hpp"
+#include "../../src/dag/static_dag.hpp"
 
 namespace baltazar {
 
 using INode = dag::INode;
 
-template <size_t NUM_OF_EDGES, typename FUNCTOR>
-using Node = dag::Node<NUM_OF_EDGES, FUNCTOR>;
+using AssignOutput = dag::AssignOutput;
+
+using ReuseOutput = dag::ReuseOutput;
+
+template <size_t NUM_OF_EDGES, typename FUNCTOR,
+          typename OUTPUT_POLICY = dag::AssignOutput>
+using Node = dag::Node<NUM_OF_EDGES, FUNCTOR, OUTPUT_POLICY>;
 
 using SortType = dag::SortType;
 
 template <size_t NUM_OF_NODES> using NodeList = dag::NodeList<NUM_OF_NODES>;
 
+template <typename T> using InputSpan = dag::InputSpan<T>;
+
+template <typename FUNCTOR, typename OUTPUT_POLICY = dag::AssignOutput>
+using DynamicNode = dag::DynamicNode<FUNCTOR, OUTPUT_POLICY>;
+
+using DynamicNodeList = dag::DynamicNodeList;
+
+template <typename FUNCTOR, size_t... DEPS>
+using StaticNode = dag::StaticNode<FUNCTOR, DEPS...>;
+
+template <typename... NODES> using StaticGraph = dag::StaticGraph<NODES...>;
+
+using dag::writeEdgeMap;
+
 } // namespace baltazar
 
 #endif
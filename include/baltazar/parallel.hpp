@@ -2,7 +2,11 @@
 #define BALTAZAR_CORE_PARALLEL_API
 
 #include "../../src/core/core_parallel.hpp"
+#include "../../src/core/histogram_profiling.hpp"
+#include "../../src/core/lock_free_profiling.hpp"
 #include "../../src/core/multithreaded_profiling.hpp"
+#include "../../src/core/sampled_profiling.hpp"
+#include "../../src/core/shm_metrics.hpp"
 
 namespace baltazar {
 
@@ -12,6 +16,22 @@ using ParallelCoreRunner = core::ParallelCoreRunner<PROFILER_TYPE>;
 template <size_t QUEUE_SIZE>
 using MultiThreadedCoreProfiler = core::MultiThreadedCoreProfiler<QUEUE_SIZE>;
 
+template <size_t RING_SIZE, size_t MAX_PRODUCERS = 4>
+using LockFreeCoreProfiler =
+    core::LockFreeCoreProfiler<RING_SIZE, MAX_PRODUCERS>;
+
+template <size_t MAX_IDENTIFIERS>
+using HistogramCoreProfiler = core::HistogramCoreProfiler<MAX_IDENTIFIERS>;
+
+using SamplingConfig = core::SamplingConfig;
+
+template <typename INNER>
+using SampledCoreProfiler = core::SampledCoreProfiler<INNER>;
+
+using SharedMemoryMetricsExporter = core::SharedMemoryMetricsExporter;
+
+using SharedMemoryMetricsReader = core::SharedMemoryMetricsReader;
+
 } // namespace baltazar
 
 #endif
@@ -1,6 +1,7 @@
 #ifndef BALTAZAR_SERIAL_CORE_API
 #define BALTAZAR_SERIAL_CORE_API
 
+#include "../../src/core/binary_trace.hpp"
 #include "../../src/core/core_serial.hpp"
 
 namespace baltazar {
@@ -11,6 +12,9 @@ using SerialCoreRunner = core::SerialCoreRunner<PROFILER_TYPE>;
 template <size_t QUEUE_SIZE>
 using SingleThreadedCoreProfiler = core::SingleThreadedCoreProfiler<QUEUE_SIZE>;
 
+template <size_t BUFFER_RECORDS>
+using BinaryTraceCoreProfiler = core::BinaryTraceCoreProfiler<BUFFER_RECORDS>;
+
 } // namespace baltazar
 
 #endif
@@ -1,6 +1,9 @@
 #ifndef BALTAZAR_THREAD_POOL_API
 #define BALTAZAR_THREAD_POOL_API
 
+#include "../../src/thread_pool/inline_task.hpp"
+#include "../../src/thread_pool/instrumentation.hpp"
+#include "../../src/thread_pool/pool_metrics.hpp"
 #include "../../src/thread_pool/thread_pool.hpp"
 #include "../../src/thread_pool/thread_task.hpp"
 
@@ -8,8 +11,29 @@ namespace baltazar {
 
 using IThreadTask = threadPool::IThreadTask;
 
-template <size_t THREAD_NUM, size_t MAX_QUEUE_SIZE>
-using ThreadPool = threadPool::ThreadPool<THREAD_NUM, MAX_QUEUE_SIZE>;
+template <typename INSTRUMENTATION>
+using BasicThreadJob = threadPool::BasicThreadJob<INSTRUMENTATION>;
+
+template <size_t CAPACITY = sizeof(void *)>
+using InlineTask = threadPool::InlineTask<CAPACITY>;
+
+template <size_t CAPACITY = sizeof(void *),
+          typename INSTRUMENTATION = threadPool::NoInstrumentation>
+using InlineThreadJob = threadPool::InlineThreadJob<CAPACITY, INSTRUMENTATION>;
+
+using NoInstrumentation = threadPool::NoInstrumentation;
+using RuntimeInstrumentation = threadPool::RuntimeInstrumentation;
+
+using WorkerMetrics = threadPool::WorkerMetrics;
+
+template <size_t THREAD_NUM>
+using PoolMetrics = threadPool::PoolMetrics<THREAD_NUM>;
+
+template <size_t THREAD_NUM, size_t MAX_QUEUE_SIZE,
+          typename JOB = threadPool::ThreadJob,
+          typename INSTRUMENTATION = typename JOB::Instrumentation>
+using ThreadPool =
+    threadPool::ThreadPool<THREAD_NUM, MAX_QUEUE_SIZE, JOB, INSTRUMENTATION>;
 
 } // namespace baltazar
 
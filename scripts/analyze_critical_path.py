@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""Find the critical path of every wave in a baltazar binary trace.
+
+A node becomes ready when the last of its dependencies is synced, so walking
+back from the last synced job of a wave through the latest synced dependency
+gives the chain that bounded the wave. Time on that chain is split into
+queueing (ready until started, including the coordinator noticing the node),
+execution and sync delay (finished until synced). Edges come from a file
+written by dag::writeEdgeMap, in the same node order the runner used.
+"""
+import argparse
+import json
+import sys
+from collections import defaultdict
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Tuple
+
+from export_chrome_trace import TraceRecordType, load_node_map, read_trace
+
+
+@dataclass
+class Job:
+    index: int
+    identifier: int
+    scheduled: int
+    started: int
+    ended: int
+    synced: int
+
+
+@dataclass
+class PathStep:
+    index: int
+    identifier: int
+    queue_ns: int
+    run_ns: int
+    sync_ns: int
+
+
+@dataclass
+class WavePath:
+    wave: int
+    duration_ns: int
+    steps: List[PathStep]
+
+    @property
+    def overhead_ns(self) -> int:
+        """Wave time outside the path, mostly collecting the last job."""
+        on_path = sum(s.queue_ns + s.run_ns + s.sync_ns for s in self.steps)
+        return max(self.duration_ns - on_path, 0)
+
+
+def load_edge_map(path: str) -> Dict[int, List[int]]:
+    """Parse "index: dep, dep" lines."""
+    edges: Dict[int, List[int]] = {}
+    for line in Path(path).read_text().splitlines():
+        if not line.strip():
+            continue
+        idx_str, deps_str = line.split(":", 1)
+        deps = [int(d) for d in deps_str.split(",") if d.strip()]
+        edges[int(idx_str.strip())] = deps
+    return edges
+
+
+def group_by_wave(filename: str) -> Tuple[Dict[int, Dict[int, Job]],
+                                          Dict[int, Tuple[int, int]]]:
+    _, records = read_trace(filename)
+    jobs: Dict[int, Dict[int, Job]] = defaultdict(dict)
+    waves: Dict[int, Tuple[int, int]] = {}
+
+    for record in records:
+        kind, _, identifier, index, wave, t0, t1, t2, t3 = record
+        if kind == TraceRecordType.JOB:
+            jobs[wave][index] = Job(index, identifier, t0, t1, t2, t3)
+        elif kind == TraceRecordType.WAVE:
+            waves[index] = (t0, t1)
+
+    return jobs, waves
+
+
+def critical_path(jobs: Dict[int, Job], edges: Dict[int, List[int]],
+                  span: Optional[Tuple[int, int]]) -> WavePath:
+    """Walk back from the last synced job through the latest synced deps.
+
+    Dependencies missing from the trace, e.g. when it was sampled, are
+    skipped; a job without traced dependencies is ready at wave start.
+    """
+    if span is None:
+        span = (min(j.scheduled for j in jobs.values()),
+                max(j.synced for j in jobs.values()))
+    wave_start, wave_end = span
+
+    steps: List[PathStep] = []
+    current: Optional[Job] = max(jobs.values(), key=lambda j: j.synced)
+    while current is not None:
+        deps = [jobs[d] for d in edges.get(current.index, []) if d in jobs]
+        previous = max(deps, key=lambda j: j.synced) if deps else None
+        ready = previous.synced if previous is not None else wave_start
+
+        steps.append(PathStep(
+            current.index, current.identifier,
+            max(current.started - ready, 0),
+            current.ended - current.started,
+            current.synced - current.ended))
+        current = previous
+
+    steps.reverse()
+    return WavePath(0, wave_end - wave_start, steps)
+
+
+def analyze(filename: str, edges: Dict[int, List[int]]) -> List[WavePath]:
+    jobs_per_wave, waves = group_by_wave(filename)
+    paths: List[WavePath] = []
+    for wave in sorted(jobs_per_wave):
+        path = critical_path(jobs_per_wave[wave], edges, waves.get(wave))
+        path.wave = wave
+        paths.append(path)
+    return paths
+
+
+def summarize(paths: List[WavePath],
+              node_map: Dict[int, str]) -> Dict[str, Any]:
+    """Per node criticality across waves.
+
+    criticality is the share of waves the node was on the critical path and
+    time_share its share of total wave time spent on the path.
+    """
+    total_ns = sum(p.duration_ns for p in paths)
+    nodes: Dict[int, Dict[str, Any]] = {}
+
+    for path in paths:
+        for step in path.steps:
+            entry = nodes.setdefault(step.index, {
+                "name": node_map.get(step.identifier,
+                                     f"task {step.identifier}"),
+                "identifier": step.identifier, "waves": 0,
+                "queue_ns": 0, "run_ns": 0, "sync_ns": 0,
+            })
+            entry["waves"] += 1
+            entry["queue_ns"] += step.queue_ns
+            entry["run_ns"] += step.run_ns
+            entry["sync_ns"] += step.sync_ns
+
+    for entry in nodes.values():
+        on_path = entry["queue_ns"] + entry["run_ns"] + entry["sync_ns"]
+        entry["criticality"] = entry["waves"] / len(paths) if paths else 0.0
+        entry["time_share"] = on_path / total_ns if total_ns else 0.0
+
+    totals = {
+        "queue_ns": sum(e["queue_ns"] for e in nodes.values()),
+        "run_ns": sum(e["run_ns"] for e in nodes.values()),
+        "sync_ns": sum(e["sync_ns"] for e in nodes.values()),
+        "overhead_ns": sum(p.overhead_ns for p in paths),
+        "wave_ns": total_ns,
+    }
+
+    return {"waves": len(paths), "totals": totals, "nodes": nodes}
+
+
+def print_summary(summary: Dict[str, Any]) -> None:
+    totals = summary["totals"]
+    wave_ns = totals["wave_ns"] or 1
+    print(f"Waves analyzed: {summary['waves']}")
+    for key in ("run_ns", "queue_ns", "sync_ns", "overhead_ns"):
+        print(f"  {key[:-3]:<9} {100.0 * totals[key] / wave_ns:6.2f}% "
+              "of wave time")
+
+    print(f"{'node':>5} {'name':<24} {'critical':>9} {'time':>8} "
+          f"{'run':>8} {'queue':>8} {'sync':>8}")
+    ranked = sorted(summary["nodes"].items(),
+                    key=lambda item: item[1]["time_share"], reverse=True)
+    for index, entry in ranked:
+        on_path = entry["queue_ns"] + entry["run_ns"] + entry["sync_ns"] or 1
+        print(f"{index:>5} {entry['name'][:24]:<24} "
+              f"{100.0 * entry['criticality']:8.2f}% "
+              f"{100.0 * entry['time_share']:7.2f}% "
+              f"{100.0 * entry['run_ns'] / on_path:7.2f}% "
+              f"{100.0 * entry['queue_ns'] / on_path:7.2f}% "
+              f"{100.0 * entry['sync_ns'] / on_path:7.2f}%")
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Per wave critical path analysis")
+    parser.add_argument("--log-file", help="Binary trace to analyze.")
+    parser.add_argument("--edge-map", help="Edges written by writeEdgeMap.")
+    parser.add_argument("--node-map", help="Node name mappings.")
+    parser.add_argument("--output", help="Optional JSON file with summary and per wave paths.")
+    args = parser.parse_args()
+
+    if not args.log_file or not args.edge_map:
+        print("Log file and edge map must be provided!")
+        sys.exit(1)
+
+    edges = load_edge_map(args.edge_map)
+    node_map = load_node_map(args.node_map) if args.node_map else {}
+    paths = analyze(args.log_file, edges)
+    summary = summarize(paths, node_map)
+    print_summary(summary)
+
+    if args.output:
+        summary["paths"] = [
+            {"wave": p.wave, "duration_ns": p.duration_ns,
+             "overhead_ns": p.overhead_ns,
+             "steps": [vars(s) for s in p.steps]}
+            for p in paths
+        ]
+        output = Path(args.output)
+        output.parent.mkdir(parents=True, exist_ok=True)
+        with output.open("w") as f:
+            json.dump(summary, f, indent=2)
+        print(f"Critical paths written to {output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -4,8 +4,12 @@ import os
 import sys
 from pathlib import Path
 import argparse
+import json
+import math
+import statistics
 import subprocess
-from typing import List
+import tempfile
+from typing import Dict, List, Tuple
 from baltazar_update_targets import collect_targets
 
 BUILD_FOLDERS_MAP = {
@@ -23,6 +27,10 @@ BUILD_COMMANDS_MAP = {
     "release": "cmake --build build-release",
 }
 
+BASELINES_FOLDER = Path("benchmark_baselines")
+
+TIME_UNIT_TO_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
 def read_lines_to_list(file_path: str) -> List[str]:
     """
     Read a text file and return a list where each element is one line (without the newline character).
@@ -169,9 +177,164 @@ def test_targets(args):
         if not all_successfull:
             print("ERROR: Some tests failed!")
 
+def run_benchmark_binary(binary: Path, args) -> Dict[str, List[float]]:
+    """
+    Run one Google Benchmark binary with repetitions and return real time of
+    every repetition in nanoseconds, keyed by benchmark name. Returns an empty
+    dict when the filter matches nothing in this binary.
+    """
+    with tempfile.TemporaryDirectory() as tmp:
+        out_file = Path(tmp) / "result.json"
+        cmd = [str(binary),
+               f"--benchmark_repetitions={args.repetitions}",
+               "--benchmark_display_aggregates_only=true",
+               f"--benchmark_out={out_file}",
+               "--benchmark_out_format=json"]
+        if args.min_time:
+            cmd.append(f"--benchmark_min_time={args.min_time}")
+        if args.filter:
+            cmd.append(f"--benchmark_filter={args.filter}")
+        print("running command: " + " ".join(cmd))
+        result = subprocess.run(cmd)
+        if result.returncode != 0:
+            print(f"ERROR: {binary.name} failed!", file=sys.stderr)
+            sys.exit(1)
+        # Google Benchmark exits with 0 and leaves the report empty when no
+        # benchmark matches the filter.
+        if not out_file.exists() or out_file.stat().st_size == 0:
+            print(f"no benchmarks ran in {binary.name}")
+            return {}
+        with out_file.open("r", encoding="utf-8") as f:
+            report = json.load(f)
+
+    times: Dict[str, List[float]] = {}
+    for entry in report.get("benchmarks", []):
+        if entry.get("run_type") != "iteration" or entry.get("error_occurred"):
+            continue
+        name = binary.name + "/" + entry["run_name"]
+        scale = TIME_UNIT_TO_NS[entry.get("time_unit", "ns")]
+        times.setdefault(name, []).append(entry["real_time"] * scale)
+    return times
+
+def mann_whitney_p_value(a: List[float], b: List[float]) -> float:
+    """
+    Two-sided Mann-Whitney U test with normal approximation and tie
+    correction. Needs no assumption about the time distribution, which is
+    usually skewed by outliers.
+    """
+    n1, n2 = len(a), len(b)
+    if n1 == 0 or n2 == 0:
+        return 1.0
+
+    values = sorted([(v, 0) for v in a] + [(v, 1) for v in b])
+    ranks = [0.0] * len(values)
+    tie_term = 0.0
+    i = 0
+    while i < len(values):
+        j = i
+        while j + 1 < len(values) and values[j + 1][0] == values[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2.0 + 1.0
+        ties = j - i + 1
+        tie_term += ties ** 3 - ties
+        i = j + 1
+
+    rank_sum_a = sum(r for r, (_, group) in zip(ranks, values) if group == 0)
+    u = rank_sum_a - n1 * (n1 + 1) / 2.0
+    n = n1 + n2
+    mean_u = n1 * n2 / 2.0
+    var_u = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)))
+    if var_u <= 0:
+        return 1.0
+    # Continuity correction.
+    z = (abs(u - mean_u) - 0.5) / math.sqrt(var_u)
+    return min(1.0, math.erfc(max(z, 0.0) / math.sqrt(2.0)))
+
+def baseline_path(config: str, name: str) -> Path:
+    return BASELINES_FOLDER / config / (name + ".json")
+
+def compare_benchmarks(baseline: Dict[str, List[float]],
+                       current: Dict[str, List[float]],
+                       args) -> List[Tuple[str, float, float, float, float, str]]:
+    rows = []
+    for name in sorted(set(baseline) | set(current)):
+        if name not in baseline or name not in current:
+            status = "new" if name in current else "missing"
+            rows.append((name, float("nan"), float("nan"), float("nan"), 1.0,
+                         status))
+            continue
+        old = statistics.median(baseline[name])
+        new = statistics.median(current[name])
+        delta = (new - old) / old * 100.0 if old > 0 else 0.0
+        p_value = mann_whitney_p_value(baseline[name], current[name])
+        status = "same"
+        if p_value < args.alpha and abs(delta) > args.threshold:
+            status = "REGRESSION" if delta > 0 else "improved"
+        rows.append((name, old, new, delta, p_value, status))
+    return rows
+
+def print_delta_table(rows) -> None:
+    width = max([len("benchmark")] + [len(row[0]) for row in rows])
+    header = (f"{'benchmark':<{width}}  {'base ns':>12}  {'new ns':>12}  "
+              f"{'delta':>8}  {'p-value':>8}  status")
+    print(header)
+    print("-" * len(header))
+    for name, old, new, delta, p_value, status in rows:
+        print(f"{name:<{width}}  {old:>12.1f}  {new:>12.1f}  "
+              f"{delta:>+7.1f}%  {p_value:>8.4f}  {status}")
+
+def bench_targets(args):
+    if args.config == "all":
+        print("ERROR: It is not allowed to benchmark both configs at the same time!")
+        sys.exit(1)
+
+    # Only Google Benchmark binaries are named *_benchmark.
+    binaries = [b for b in list_baltazar_binaries(args.config)
+                if b.name.endswith("_benchmark")]
+    if args.target:
+        binaries = [b for b in binaries if b.name == args.target]
+        if not binaries:
+            print("ERROR: binary doesn't exist!")
+            sys.exit(1)
+
+    current: Dict[str, List[float]] = {}
+    for binary in binaries:
+        current.update(run_benchmark_binary(binary, args))
+    if not current:
+        print("ERROR: no benchmarks ran!", file=sys.stderr)
+        sys.exit(1)
+
+    if args.save_baseline:
+        path = baseline_path(args.config, args.save_baseline)
+        path.parent.mkdir(parents=True, exist_ok=True)
+        with path.open("w", encoding="utf-8") as f:
+            json.dump({"repetitions": args.repetitions, "benchmarks": current},
+                      f, indent=2)
+        print(f"saved baseline {args.save_baseline} to {path}")
+
+    if args.baseline:
+        path = baseline_path(args.config, args.baseline)
+        if not path.exists():
+            print(f"ERROR: no baseline {args.baseline} at {path}", file=sys.stderr)
+            sys.exit(1)
+        with path.open("r", encoding="utf-8") as f:
+            baseline = json.load(f)["benchmarks"]
+        # With a target or filter only the benchmarks that ran are compared.
+        if args.target or args.filter:
+            baseline = {k: v for k, v in baseline.items() if k in current}
+
+        rows = compare_benchmarks(baseline, current, args)
+        print_delta_table(rows)
+        regressions = [row for row in rows if row[5] == "REGRESSION"]
+        if regressions:
+            print(f"ERROR: {len(regressions)} benchmarks regressed by more than "
+                  f"{args.threshold}%!")
+            sys.exit(1)
+
 def main():
     parser = argparse.ArgumentParser(description="List Baltazar binaries for a given config.")
-    parser.add_argument("command", choices=["configure", "build", "run", "list", "test", "build_and_run", "build_and_test", "clang_check"], help="Select which action to perform.")
+    parser.add_argument("command", choices=["configure", "build", "run", "list", "test", "build_and_run", "build_and_test", "clang_check", "bench"], help="Select which action to perform.")
     parser.add_argument("--target", help="Select which specific target to build or run.")
     parser.add_argument(
         "--config",
@@ -181,6 +344,13 @@ def main():
     )
     parser.add_argument("--print-log", action="store_true", help="Turn on log prints in configure step.")
     parser.add_argument("--verbose", action="store_true", help="Turn on verbose output.")
+    parser.add_argument("--save-baseline", help="Store bench results under this baseline name.")
+    parser.add_argument("--baseline", help="Compare bench results against this baseline name.")
+    parser.add_argument("--repetitions", type=int, default=10, help="Bench repetitions per benchmark (default: 10).")
+    parser.add_argument("--threshold", type=float, default=5.0, help="Bench regression threshold in percent of median time (default: 5).")
+    parser.add_argument("--alpha", type=float, default=0.05, help="Bench significance level of the Mann-Whitney test (default: 0.05).")
+    parser.add_argument("--filter", help="Bench regex passed to --benchmark_filter.")
+    parser.add_argument("--min-time", help="Bench value passed to --benchmark_min_time.")
     args = parser.parse_args()
     
     if args.command == "list":
@@ -223,6 +393,9 @@ def main():
         build_targets(args) 
         test_targets(args)
     
+    if args.command == "bench":
+        bench_targets(args)
+
     if args.command == "clang_check":
         print("Running clang-check")
         subprocess.run(["mkdir", "-p", "temp"], text=True)
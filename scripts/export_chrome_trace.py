@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""Export a baltazar binary trace to Chrome Trace Event JSON.
+
+The output loads in https://ui.perfetto.dev or chrome://tracing. Every worker
+gets its own track with job spans, the coordinator track holds run and wave
+spans plus scheduling flow arrows, and logCustomDiff spans get a separate track.
+Jobs of the serial runner run on the coordinator and are drawn on its track.
+"""
+import argparse
+import json
+import sys
+from pathlib import Path
+from typing import Any, Dict, Iterator, List, Tuple
+
+from process_profiling_logs import (COORDINATOR_THREAD_ID, TraceRecordType,
+                                    load_node_map, read_binary_trace)
+
+PROCESS_ID = 1
+COORDINATOR_TID = 0
+CUSTOM_TID = 1
+WORKER_TID_OFFSET = 2
+
+
+def read_trace(filename: str) -> Tuple[Dict[str, int], Iterator[Tuple[int, ...]]]:
+    """Read header and return an iterator over raw record tuples.
+
+    Tuples follow the record layout: type, thread_id, identifier, index, wave,
+    t0, t1, t2, t3.
+    """
+    header, records = read_binary_trace(filename)
+    return header, iter(records.tolist())
+
+
+def span(name: str, tid: int, start_us: float, end_us: float,
+         args: Dict[str, Any]) -> Dict[str, Any]:
+    return {
+        "name": name, "ph": "X", "pid": PROCESS_ID, "tid": tid,
+        "ts": start_us, "dur": max(end_us - start_us, 0.0), "args": args,
+    }
+
+
+def thread_metadata(tid: int, name: str) -> List[Dict[str, Any]]:
+    return [
+        {"name": "thread_name", "ph": "M", "pid": PROCESS_ID, "tid": tid,
+         "args": {"name": name}},
+        {"name": "thread_sort_index", "ph": "M", "pid": PROCESS_ID,
+         "tid": tid, "args": {"sort_index": tid}},
+    ]
+
+
+def convert(filename: str, node_map: Dict[int, str],
+            with_flows: bool) -> Dict[str, Any]:
+    header, records = read_trace(filename)
+    origin = header["steady_origin_ns"]
+
+    def to_us(ns: int) -> float:
+        return (ns - origin) / 1000.0
+
+    events: List[Dict[str, Any]] = []
+    workers = set()
+    has_custom = False
+    flow_id = 0
+
+    for record in records:
+        kind, thread_id, identifier, index, wave, t0, t1, t2, t3 = record
+
+        if kind == TraceRecordType.JOB:
+            on_coordinator = thread_id == COORDINATOR_THREAD_ID
+            tid = COORDINATOR_TID if on_coordinator else \
+                WORKER_TID_OFFSET + thread_id
+            if not on_coordinator:
+                workers.add(thread_id)
+            name = node_map.get(identifier, f"task {identifier}")
+            events.append(span(name, tid, to_us(t1), to_us(t2), {
+                "task": identifier, "job": index, "wave": wave,
+                "queue_us": (t1 - t0) / 1000.0,
+                "sync_us": (t3 - t2) / 1000.0,
+            }))
+
+            if with_flows and not on_coordinator:
+                flow_id += 1
+                flow = {"name": "schedule", "cat": "schedule",
+                        "id": flow_id, "pid": PROCESS_ID}
+                events.append(dict(flow, ph="s", tid=COORDINATOR_TID,
+                                   ts=to_us(t0)))
+                events.append(dict(flow, ph="f", bp="e", tid=tid,
+                                   ts=to_us(t1)))
+        elif kind == TraceRecordType.WAVE:
+            events.append(span(f"wave {index}", COORDINATOR_TID, to_us(t0),
+                               to_us(t1), {"wave": index}))
+        elif kind == TraceRecordType.RUN:
+            events.append(span("run", COORDINATOR_TID, to_us(t0), to_us(t1),
+                               {"last_wave": wave}))
+        elif kind == TraceRecordType.CUSTOM:
+            has_custom = True
+            events.append(span(f"custom {identifier}", CUSTOM_TID, to_us(t0),
+                               to_us(t1), {"identifier": identifier,
+                                           "wave": wave}))
+
+    metadata: List[Dict[str, Any]] = [
+        {"name": "process_name", "ph": "M", "pid": PROCESS_ID,
+         "args": {"name": "baltazar"}},
+    ]
+    metadata += thread_metadata(COORDINATOR_TID, "coordinator")
+    if has_custom:
+        metadata += thread_metadata(CUSTOM_TID, "custom spans")
+    for worker in sorted(workers):
+        metadata += thread_metadata(WORKER_TID_OFFSET + worker,
+                                    f"worker {worker}")
+
+    return {
+        "traceEvents": metadata + events,
+        "displayTimeUnit": "ns",
+        "otherData": {"system_origin_ns": header["system_origin_ns"]},
+    }
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Export binary trace to Chrome Trace Event JSON")
+    parser.add_argument("--log-file", help="Binary trace to export.")
+    parser.add_argument("--output", default="temp/trace.json", help="Output JSON file.")
+    parser.add_argument("--node-map", help="Node name mappings.")
+    parser.add_argument("--no-flows", action="store_true", help="Skip scheduling flow arrows.")
+    args = parser.parse_args()
+
+    if not args.log_file:
+        print("Log file not provided!")
+        sys.exit(1)
+
+    node_map = load_node_map(args.node_map) if args.node_map else {}
+    trace = convert(args.log_file, node_map, not args.no_flows)
+
+    output = Path(args.output)
+    output.parent.mkdir(parents=True, exist_ok=True)
+    with output.open("w") as f:
+        json.dump(trace, f)
+
+    print(f"Trace with {len(trace['traceEvents'])} events written to {output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,7 +1,6 @@
 import yaml
 import sys
 import argparse
-import matplotlib.pyplot as plt
 import numpy as np
 from pathlib import Path
 from typing import Tuple, Dict, Any
@@ -202,6 +201,98 @@ def parse_file(filename: str) -> Tuple[NDArray[np.float64], NDArray[np.float64],
     return w_array, j_array, r_array 
 
 
+TRACE_MAGIC = 0x5A544C42
+TRACE_VERSION = 1
+
+# Thread id of jobs run by the coordinator itself, e.g. by SerialCoreRunner.
+COORDINATOR_THREAD_ID = 0xFFFFFFFF
+
+class TraceRecordType(IntEnum):
+    JOB = 0
+    WAVE = 1
+    RUN = 2
+    CUSTOM = 3
+
+TRACE_HEADER_DTYPE = np.dtype([
+    ("magic", "<u4"), ("version", "<u2"), ("record_size", "<u2"),
+    ("steady_origin_ns", "<i8"), ("system_origin_ns", "<i8"),
+    ("reserved", "<u8", (5,)),
+])
+
+TRACE_RECORD_DTYPE = np.dtype([
+    ("type", "<u4"), ("thread_id", "<u4"), ("identifier", "<u8"),
+    ("index", "<u8"), ("wave", "<u8"),
+    ("t0", "<i8"), ("t1", "<i8"), ("t2", "<i8"), ("t3", "<i8"),
+])
+
+
+def is_binary_trace(filename: str) -> bool:
+    """Check whether the file starts with the binary trace magic."""
+    with open(filename, "rb") as f:
+        magic = f.read(4)
+    return len(magic) == 4 and int.from_bytes(magic, "little") == TRACE_MAGIC
+
+
+def read_binary_trace(filename: str) -> Tuple[Dict[str, int], NDArray[Any]]:
+    """Memory map a binary trace. Records are not copied until used."""
+    headers = np.fromfile(filename, dtype=TRACE_HEADER_DTYPE, count=1)
+    if headers.size == 0:
+        raise ValueError(f"{filename} is too short to be a binary trace")
+    header = headers[0]
+    if int(header["magic"]) != TRACE_MAGIC:
+        raise ValueError(f"{filename} is not a binary trace")
+    if int(header["version"]) != TRACE_VERSION:
+        raise ValueError(f"Unsupported trace version {int(header['version'])}")
+    if int(header["record_size"]) != TRACE_RECORD_DTYPE.itemsize:
+        raise ValueError(f"Unexpected record size {int(header['record_size'])}")
+
+    header_info = {
+        "version": int(header["version"]),
+        "steady_origin_ns": int(header["steady_origin_ns"]),
+        "system_origin_ns": int(header["system_origin_ns"]),
+    }
+
+    data_size = Path(filename).stat().st_size - TRACE_HEADER_DTYPE.itemsize
+    count = data_size // TRACE_RECORD_DTYPE.itemsize
+    if count == 0:
+        return header_info, np.empty((0,), dtype=TRACE_RECORD_DTYPE)
+
+    records = np.memmap(filename, dtype=TRACE_RECORD_DTYPE, mode="r",
+                        offset=TRACE_HEADER_DTYPE.itemsize, shape=(count,))
+    return header_info, records
+
+
+def parse_binary_file(filename: str) -> Tuple[NDArray[np.float64], NDArray[np.float64], NDArray[np.float64]]:
+    """Convert a binary trace into the same W, J and R arrays as parse_file."""
+    _, records = read_binary_trace(filename)
+    kinds = records["type"]
+
+    jobs = records[kinds == TraceRecordType.JOB]
+    waves = records[kinds == TraceRecordType.WAVE]
+    runs = records[kinds == TraceRecordType.RUN]
+
+    j_array: NDArray[np.float64] = np.empty((0,))
+    if jobs.size > 0:
+        j_array = np.column_stack((
+            jobs["identifier"], jobs["index"], jobs["thread_id"],
+            (jobs["t1"] - jobs["t0"]) // 1000,
+            (jobs["t2"] - jobs["t1"]) // 1000,
+            (jobs["t3"] - jobs["t2"]) // 1000,
+        )).astype(np.float64)
+
+    w_array: NDArray[np.float64] = np.empty((0,))
+    if waves.size > 0:
+        w_array = np.column_stack((
+            waves["index"], (waves["t1"] - waves["t0"]) // 1000,
+        )).astype(np.float64)
+
+    r_array: NDArray[np.float64] = np.empty((0,))
+    if runs.size > 0:
+        r_array = ((runs["t1"] - runs["t0"]) // 1000).astype(np.float64).reshape(-1, 1)
+
+    return w_array, j_array, r_array
+
+
 def save_stats_to_yaml(stats: Dict[str, Any], filename: str) -> None:
     """Save stats dictionary to a YAML file."""
     with open(filename, "w") as f:
@@ -218,6 +309,8 @@ def load_node_map(path: str) -> dict[int, str]:
     return mapping
 
 def create_histograms(arr: NDArray[np.uint64 | np.float64], prefix: str):
+    # Imported here, so trace definitions can be imported without matplotlib.
+    import matplotlib.pyplot as plt
     num_cols = arr.shape[1]
 
     for i in range(num_cols):
@@ -230,6 +323,7 @@ def create_histograms(arr: NDArray[np.uint64 | np.float64], prefix: str):
         plt.close()
 
 def create_plot(x: NDArray[np.uint64 | np.float64], y: NDArray[np.uint64 | np.float64], prefix : str):
+    import matplotlib.pyplot as plt
     plt.figure(figsize=(6, 4)) # type: ignore
     plt.plot(x, y)# type: ignore
     plt.xlabel("iteration")# type: ignore
@@ -240,7 +334,7 @@ def create_plot(x: NDArray[np.uint64 | np.float64], y: NDArray[np.uint64 | np.fl
 
 def main() -> None:
     parser = argparse.ArgumentParser(description="Process profiling logs")
-    parser.add_argument("--log-file", help="Log file to process.")
+    parser.add_argument("--log-file", help="Log file to process, text or binary trace.")
     parser.add_argument("--output", help="Output folder.")
     parser.add_argument("--node-map", help="Node name mappings.")
     args = parser.parse_args()
@@ -257,7 +351,10 @@ def main() -> None:
     graphs_dir = Path("temp/graphs")
     graphs_dir.mkdir(parents=True, exist_ok=True)
 
-    w_array, j_array, r_array = parse_file(input_file)
+    if is_binary_trace(input_file):
+        w_array, j_array, r_array = parse_binary_file(input_file)
+    else:
+        w_array, j_array, r_array = parse_file(input_file)
  
     stats, task_stats, thread_stats = compute_job_stats(j_array, r_array)
     print("Job statitics calculated")
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+# Run with: python3 -m unittest discover -s scripts
+import argparse
+import json
+import stat
+import sys
+import tempfile
+import unittest
+from contextlib import redirect_stderr, redirect_stdout
+from io import StringIO
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent))
+
+import baltazar_controller as controller
+
+# Stands in for a Google Benchmark binary: writes a report with one benchmark
+# if the filter matches its name, otherwise an empty report, and exits with 0
+# either way, like Google Benchmark does.
+FAKE_BENCHMARK = """#!{python}
+import sys
+args = dict(a.split("=", 1) for a in sys.argv[1:] if "=" in a)
+pattern = args.get("--benchmark_filter", "")
+report = ""
+if pattern in "{name}":
+    report = '{{"benchmarks": [{{"run_name": "{name}", ' \\
+             '"run_type": "iteration", "real_time": 2.0, "time_unit": "us"}}]}}'
+with open(args["--benchmark_out"], "w") as f:
+    f.write(report)
+"""
+
+
+def bench_args(**overrides) -> argparse.Namespace:
+    args = argparse.Namespace(config="release", target=None, filter=None,
+                              min_time=None, repetitions=1,
+                              save_baseline=None, baseline=None,
+                              threshold=5.0, alpha=0.05)
+    for key, value in overrides.items():
+        setattr(args, key, value)
+    return args
+
+
+class BenchTest(unittest.TestCase):
+    def setUp(self):
+        self.tmp = tempfile.TemporaryDirectory()
+        self.bin_dir = Path(self.tmp.name) / "bin"
+        self.bin_dir.mkdir()
+        self.saved_folders = controller.BUILD_FOLDERS_MAP
+        self.saved_baselines = controller.BASELINES_FOLDER
+        controller.BUILD_FOLDERS_MAP = {"release": self.bin_dir}
+        controller.BASELINES_FOLDER = Path(self.tmp.name) / "baselines"
+        self.add_fake("baltazar_a_benchmark", "BM_Alpha")
+        self.add_fake("baltazar_b_benchmark", "BM_Beta")
+
+    def tearDown(self):
+        controller.BUILD_FOLDERS_MAP = self.saved_folders
+        controller.BASELINES_FOLDER = self.saved_baselines
+        self.tmp.cleanup()
+
+    def add_fake(self, binary_name: str, benchmark_name: str) -> Path:
+        path = self.bin_dir / binary_name
+        path.write_text(FAKE_BENCHMARK.format(python=sys.executable,
+                                              name=benchmark_name))
+        path.chmod(path.stat().st_mode | stat.S_IXUSR)
+        return path
+
+    def test_binary_without_matching_benchmarks_returns_nothing(self):
+        with redirect_stdout(StringIO()):
+            times = controller.run_benchmark_binary(
+                self.bin_dir / "baltazar_a_benchmark",
+                bench_args(filter="BM_Beta"))
+
+        self.assertEqual(times, {})
+
+    def test_filter_skips_binaries_without_matches(self):
+        args = bench_args(filter="BM_Beta", save_baseline="base")
+
+        with redirect_stdout(StringIO()):
+            controller.bench_targets(args)
+
+        path = controller.baseline_path("release", "base")
+        with path.open("r", encoding="utf-8") as f:
+            saved = json.load(f)["benchmarks"]
+        self.assertEqual(saved, {"baltazar_b_benchmark/BM_Beta": [2000.0]})
+
+    def test_filter_without_any_match_fails(self):
+        with redirect_stdout(StringIO()), redirect_stderr(StringIO()):
+            with self.assertRaises(SystemExit):
+                controller.bench_targets(bench_args(filter="BM_Gamma"))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,207 @@
+#include "../../dag/dag_generator.hpp"
+#include "../core_parallel.hpp"
+#include "../core_serial.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <vector>
+
+// Generated graphs run by ParallelCoreRunner next to the same graphs written
+// as OpenMP tasks with depend clauses and as std::async futures, one wave per
+// iteration. Arguments are number of nodes, shape (dag::GraphShape value) and
+// node cost in generatedWork units. Every implementation computes the same
+// outputs as GeneratedTask and is checked against a serial reference sum.
+// OpenMP benchmarks are only built when the compiler supports it.
+namespace baltazar {
+
+constexpr size_t poolQueueSize = 256;
+// std::async starts a thread per node and blocked nodes hold theirs, so
+// larger graphs would only measure thread creation limits.
+constexpr std::int64_t maxAsyncNodes = 1000;
+
+dag::GeneratedGraph generateBaselineGraph(const benchmark::State &state) {
+  dag::GraphSpec spec{};
+  spec._numberOfNodes = static_cast<size_t>(state.range(0));
+  spec._shape = static_cast<dag::GraphShape>(state.range(1));
+  spec._width = std::max<size_t>(
+      1, static_cast<size_t>(std::sqrt(spec._numberOfNodes)));
+  spec._maxFanIn = 3;
+  spec._edgeProbability = 4.0 / static_cast<double>(spec._numberOfNodes);
+  spec._meanCost = static_cast<std::uint64_t>(state.range(2));
+  spec._seed = 3;
+  return dag::generateGraph(spec);
+}
+
+// Same computation as GeneratedTask.
+std::uint64_t runGeneratedNode(const dag::GeneratedGraph &graph, size_t index,
+                               const std::uint64_t *outputs) {
+  std::uint64_t value = graph._costs[index];
+  for (size_t dep : graph._deps[index]) {
+    value += outputs[dep];
+  }
+  return dag::generatedWork(value, graph._costs[index]);
+}
+
+std::uint64_t referenceSum(const dag::GeneratedGraph &graph) {
+  std::vector<std::uint64_t> outputs(graph.getNumberOfNodes());
+  std::uint64_t sum = 0;
+  for (size_t i = 0; i < outputs.size(); i++) {
+    outputs[i] = runGeneratedNode(graph, i, outputs.data());
+    sum += outputs[i];
+  }
+  return sum;
+}
+
+void finishBaseline(benchmark::State &state, const dag::GeneratedGraph &graph,
+                    std::uint64_t sum) {
+  if (sum != referenceSum(graph)) {
+    state.SkipWithError("Outputs differ from serial reference.");
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(graph.getNumberOfNodes()));
+  state.counters["edges"] = static_cast<double>(graph.getNumberOfEdges());
+}
+
+std::uint64_t sumNodeOutputs(dag::DynamicNodeList &nodes) {
+  std::uint64_t sum = 0;
+  for (size_t i = 0; i < nodes.getNumberOfNodes(); i++) {
+    sum += *static_cast<std::uint64_t *>(nodes.getNodeAt(i)->getOutputPtr());
+  }
+  return sum;
+}
+
+// Single thread reference line.
+// NOLINTNEXTLINE
+static void BM_BaselineSerialRunner(benchmark::State &state) {
+  dag::GeneratedGraph graph = generateBaselineGraph(state);
+  dag::DynamicNodeList nodes{graph.getNumberOfNodes()};
+  dag::buildNodeList(graph, nodes);
+  nodes.sortNodes(dag::SortType::Depth);
+  std::atomic<bool> stopFlag{false};
+  core::SerialCoreRunner runner{};
+
+  for (auto _ : state) {
+    runner.runNodeListSerialOnce(nodes, stopFlag);
+  }
+
+  finishBaseline(state, graph, sumNodeOutputs(nodes));
+}
+
+template <size_t THREADS>
+// NOLINTNEXTLINE
+static void BM_BaselineParallelRunner(benchmark::State &state) {
+  dag::GeneratedGraph graph = generateBaselineGraph(state);
+  dag::DynamicNodeList nodes{graph.getNumberOfNodes()};
+  dag::buildNodeList(graph, nodes);
+  nodes.sortNodes(dag::SortType::Depth);
+  std::atomic<bool> stopFlag{false};
+  core::CoreThreadPool<THREADS, poolQueueSize, threadPool::NoInstrumentation>
+      tPool{};
+  core::ParallelCoreRunner runner{};
+
+  for (auto _ : state) {
+    runner.runNodeListParallelOnce(nodes, tPool, stopFlag);
+  }
+
+  finishBaseline(state, graph, sumNodeOutputs(nodes));
+}
+
+#ifdef _OPENMP
+// One task per node, created in index order by a single thread. Dependencies
+// are expressed on output slots with an iterator over the node's deps.
+template <size_t THREADS>
+// NOLINTNEXTLINE
+static void BM_BaselineOpenMpTasks(benchmark::State &state) {
+  dag::GeneratedGraph graph = generateBaselineGraph(state);
+  const size_t numberOfNodes = graph.getNumberOfNodes();
+  std::vector<std::uint64_t> outputs(numberOfNodes);
+  std::uint64_t *out = outputs.data();
+  const dag::GeneratedGraph *g = &graph;
+
+  for (auto _ : state) {
+#pragma omp parallel num_threads(THREADS)
+#pragma omp single
+    for (size_t i = 0; i < numberOfNodes; i++) {
+      const size_t *deps = g->_deps[i].data();
+      const size_t numberOfDeps = g->_deps[i].size();
+#pragma omp task firstprivate(i) depend(iterator(d = 0 : numberOfDeps),      \
+                                            in : out[deps[d]])                 \
+    depend(out : out[i])
+      out[i] = runGeneratedNode(*g, i, out);
+    }
+  }
+
+  std::uint64_t sum = 0;
+  for (std::uint64_t value : outputs) {
+    sum += value;
+  }
+  finishBaseline(state, graph, sum);
+}
+#endif
+
+// Every node is a std::async task waiting on shared futures of its deps.
+// NOLINTNEXTLINE
+static void BM_BaselineAsyncFutures(benchmark::State &state) {
+  if (state.range(0) > maxAsyncNodes) {
+    state.SkipWithError("Too many nodes for a thread per node.");
+    return;
+  }
+
+  dag::GeneratedGraph graph = generateBaselineGraph(state);
+  const size_t numberOfNodes = graph.getNumberOfNodes();
+  std::vector<std::shared_future<std::uint64_t>> futures(numberOfNodes);
+  std::uint64_t sum = 0;
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < numberOfNodes; i++) {
+      // Deps have lower indices, so their futures are set before this one
+      // starts.
+      futures[i] = std::async(std::launch::async, [&graph, &futures, i] {
+                     std::uint64_t value = graph._costs[i];
+                     for (size_t dep : graph._deps[i]) {
+                       value += futures[dep].get();
+                     }
+                     return dag::generatedWork(value, graph._costs[i]);
+                   }).share();
+    }
+    sum = 0;
+    for (auto &future : futures) {
+      sum += future.get();
+    }
+  }
+
+  finishBaseline(state, graph, sum);
+}
+
+void baselineArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"nodes", "shape", "cost"});
+  for (auto shape : {dag::GraphShape::Layered, dag::GraphShape::Random}) {
+    for (std::int64_t nodes : {100, 1000, 10000}) {
+      for (std::int64_t cost : {0, 1000}) {
+        benchmark->Args({nodes, static_cast<std::int64_t>(shape), cost});
+      }
+    }
+  }
+  benchmark->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
+
+BENCHMARK(BM_BaselineSerialRunner)->Apply(baselineArguments);
+BENCHMARK_TEMPLATE(BM_BaselineParallelRunner, 1)->Apply(baselineArguments);
+BENCHMARK_TEMPLATE(BM_BaselineParallelRunner, 2)->Apply(baselineArguments);
+BENCHMARK_TEMPLATE(BM_BaselineParallelRunner, 4)->Apply(baselineArguments);
+BENCHMARK_TEMPLATE(BM_BaselineParallelRunner, 8)->Apply(baselineArguments);
+#ifdef _OPENMP
+BENCHMARK_TEMPLATE(BM_BaselineOpenMpTasks, 1)->Apply(baselineArguments);
+BENCHMARK_TEMPLATE(BM_BaselineOpenMpTasks, 2)->Apply(baselineArguments);
+BENCHMARK_TEMPLATE(BM_BaselineOpenMpTasks, 4)->Apply(baselineArguments);
+BENCHMARK_TEMPLATE(BM_BaselineOpenMpTasks, 8)->Apply(baselineArguments);
+#endif
+BENCHMARK(BM_BaselineAsyncFutures)->Apply(baselineArguments);
+
+} // namespace baltazar
+
+BENCHMARK_MAIN();
@@ -1,5 +1,3 @@
-#define PROFILELOG
-
 #include "../core_parallel.hpp"
 #include "../core_serial.hpp"
 #include "multithreaded_profiling.hpp"
@@ -17,6 +15,8 @@ namespace baltazar {
 constexpr size_t numberOfIterations = 1;
 constexpr size_t numberOfLoops = 1000;
 constexpr size_t numberOfThreads = 8;
+// Profiler can be switched at runtime, this only sets its initial state.
+constexpr bool profilingOn = true;
 
 class TaskA {
 public:
@@ -174,7 +174,6 @@ static void BM_RunSerial(benchmark::State &state) {
 
   std::atomic<bool> stopFlag{false};
 
-#ifdef PROFILELOG
   fs::path logPath = getNewLogPath();
   std::ofstream out(logPath);
   if (!out) {
@@ -182,14 +181,11 @@ static void BM_RunSerial(benchmark::State &state) {
     return;
   }
 
-  core::SerialCoreRunner<core::MultiThreadedCoreProfiler<100>> runner{&out,
-                                                                      true};
-  // core::SerialCoreRunner<core::SingleThreadedCoreProfiler<100>> runner{&out,
-  //                                                                      true};
+  core::SerialCoreRunner<core::MultiThreadedCoreProfiler<100>> runner{
+      &out, profilingOn};
+  // core::SerialCoreRunner<core::SingleThreadedCoreProfiler<100>> runner{
+  //     &out, profilingOn};
   // core::SerialCoreRunner runner;
-#else
-  core::SerialCoreRunner runner;
-#endif
 
   for (auto _ : state) {
     runner.runNodeListSerialNTimes(nodeList, stopFlag, numberOfLoops);
@@ -251,7 +247,6 @@ static void BM_RunParallel(benchmark::State &state) {
   std::atomic<bool> stopFlag{false};
   threadPool::ThreadPool<numberOfThreads, 10> tPool{};
 
-#ifdef PROFILELOG
   fs::path logPath = getNewLogPath();
   std::ofstream out(logPath);
   if (!out) {
@@ -259,15 +254,11 @@ static void BM_RunParallel(benchmark::State &state) {
     return;
   }
 
-  core::ParallelCoreRunner<core::MultiThreadedCoreProfiler<100>> runner{&out,
-                                                                        true};
-  // core::ParallelCoreRunner<core::SingleThreadedCoreProfiler<100>>
-  // runner{&out,
-  //                                                                        true};
+  core::ParallelCoreRunner<core::MultiThreadedCoreProfiler<100>> runner{
+      &out, profilingOn};
+  // core::ParallelCoreRunner<core::SingleThreadedCoreProfiler<100>> runner{
+  //     &out, profilingOn};
   // core::ParallelCoreRunner runner;
-#else
-  core::ParallelCoreRunner runner;
-#endif
 
   for (auto _ : state) {
     runner.runNodeListParallelNTimes(nodeList, tPool, stopFlag, numberOfLoops);
@@ -0,0 +1,215 @@
+#include "../../dag/dag_generator.hpp"
+#include "../core_parallel.hpp"
+#include "../core_serial.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Startup cost of a graph: building the node list, sorting it and running the
+// first wave. Arguments are number of nodes, shape (0 layered, 1 deep chain)
+// and fan-in of layered graphs, which sets edge density. Deep chains check
+// that the iterative sort handles a million levels. Graphs are generated
+// before timing, so only node list work is measured.
+namespace baltazar {
+
+constexpr size_t numberOfThreads = 4;
+constexpr size_t poolQueueSize = 256;
+constexpr std::int64_t maxNodes = 1000000;
+// Longest deep chain run in parallel, see README.
+constexpr std::int64_t maxParallelChainNodes = 10000;
+
+dag::GeneratedGraph generateBuildGraph(const benchmark::State &state) {
+  dag::GraphSpec spec{};
+  spec._numberOfNodes = static_cast<size_t>(state.range(0));
+  spec._shape = state.range(1) == 0 ? dag::GraphShape::Layered
+                                    : dag::GraphShape::DeepChain;
+  spec._maxFanIn = static_cast<size_t>(state.range(2));
+  // Wide enough for the fan-in and about as wide as deep.
+  spec._width = std::max(
+      spec._maxFanIn,
+      static_cast<size_t>(std::sqrt(static_cast<double>(spec._numberOfNodes))));
+  spec._seed = 7;
+  return dag::generateGraph(spec);
+}
+
+// Sized so nodes and their dependency arrays fit the first arena block.
+size_t bytesPerNode(const dag::GeneratedGraph &graph) {
+  return dag::DynamicNodeList::defaultBytesPerNode +
+         graph.getNumberOfEdges() / graph.getNumberOfNodes() *
+             sizeof(dag::INode *) +
+         sizeof(dag::INode *);
+}
+
+void setGraphCounters(benchmark::State &state,
+                      const dag::GeneratedGraph &graph) {
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(graph.getNumberOfNodes()));
+  state.counters["edges"] = static_cast<double>(graph.getNumberOfEdges());
+}
+
+void addBuildArguments(benchmark::internal::Benchmark *benchmark,
+                       std::int64_t maxChainNodes) {
+  benchmark->ArgNames({"nodes", "shape", "fan_in"});
+  for (std::int64_t nodes = 100; nodes <= maxNodes; nodes *= 10) {
+    for (std::int64_t fanIn : {1, 4, 16}) {
+      benchmark->Args({nodes, 0, fanIn});
+    }
+    if (nodes <= maxChainNodes) {
+      benchmark->Args({nodes, 1, 1});
+    }
+  }
+  benchmark->Unit(benchmark::kMicrosecond);
+}
+
+void buildArguments(benchmark::internal::Benchmark *benchmark) {
+  addBuildArguments(benchmark, maxNodes);
+}
+
+void parallelBuildArguments(benchmark::internal::Benchmark *benchmark) {
+  addBuildArguments(benchmark, maxParallelChainNodes);
+}
+
+// Emplacing nodes and setting dependencies. List teardown is part of every
+// iteration.
+// NOLINTNEXTLINE
+static void BM_BuildNodeList(benchmark::State &state) {
+  dag::GeneratedGraph graph = generateBuildGraph(state);
+
+  for (auto _ : state) {
+    dag::DynamicNodeList nodes{graph.getNumberOfNodes(), bytesPerNode(graph)};
+    dag::buildNodeList(graph, nodes);
+    benchmark::DoNotOptimize(nodes.getNodeAt(0));
+  }
+
+  setGraphCounters(state, graph);
+}
+BENCHMARK(BM_BuildNodeList)->Apply(buildArguments);
+
+// Fixed capacity NodeList filled with already built nodes.
+template <size_t NUM_OF_NODES>
+// NOLINTNEXTLINE
+static void BM_NodeListAddNode(benchmark::State &state) {
+  dag::GraphSpec spec{};
+  spec._numberOfNodes = NUM_OF_NODES;
+  dag::GeneratedGraph graph = dag::generateGraph(spec);
+  dag::DynamicNodeList source{NUM_OF_NODES};
+  dag::buildNodeList(graph, source);
+
+  for (auto _ : state) {
+    auto nodes = std::make_unique<dag::NodeList<NUM_OF_NODES>>();
+    for (size_t i = 0; i < NUM_OF_NODES; i++) {
+      nodes->addNode(source.getNodeAt(i));
+    }
+    nodes->sortNodes(dag::SortType::Topological);
+    benchmark::DoNotOptimize(nodes->getNodeAt(0));
+  }
+
+  setGraphCounters(state, graph);
+}
+BENCHMARK_TEMPLATE(BM_NodeListAddNode, 100)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_NodeListAddNode, 1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_NodeListAddNode, 10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_NodeListAddNode, 100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_NodeListAddNode, 1000000)->Unit(benchmark::kMicrosecond);
+
+// Sorts a shuffled copy of the node array every iteration, so no run sorts
+// already sorted input. Copying is a memcpy, small next to the sort. Fourth
+// argument is the dag::SortType value.
+// NOLINTNEXTLINE
+static void BM_SortNodes(benchmark::State &state) {
+  dag::GeneratedGraph graph = generateBuildGraph(state);
+  dag::DynamicNodeList nodes{graph.getNumberOfNodes(), bytesPerNode(graph)};
+  dag::buildNodeList(graph, nodes);
+
+  std::mt19937_64 gen(11);
+  std::vector<dag::INode *> shuffled;
+  shuffled.reserve(nodes.getNumberOfNodes());
+  for (size_t i = 0; i < nodes.getNumberOfNodes(); i++) {
+    nodes.getNodeAt(i)->setPriority(gen() % 100UL);
+    shuffled.push_back(nodes.getNodeAt(i));
+  }
+  std::shuffle(shuffled.begin(), shuffled.end(), gen);
+
+  const auto sortType = static_cast<dag::SortType>(state.range(3));
+  auto byIdentifier = [](const dag::INode *a, const dag::INode *b) {
+    return a->getIdentifier() < b->getIdentifier();
+  };
+  std::vector<dag::INode *> working(shuffled.size());
+
+  for (auto _ : state) {
+    std::copy(shuffled.begin(), shuffled.end(), working.begin());
+    dag::detail::NodeSorter::sortNodes(working.data(), working.size(),
+                                       sortType, byIdentifier);
+    benchmark::DoNotOptimize(working.data());
+  }
+
+  setGraphCounters(state, graph);
+}
+
+void sortArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"nodes", "shape", "fan_in", "sort"});
+  for (std::int64_t sort = 0;
+       sort <= static_cast<std::int64_t>(dag::SortType::CustomPriority);
+       sort++) {
+    for (std::int64_t nodes = 100; nodes <= 1000000; nodes *= 10) {
+      benchmark->Args({nodes, 0, 4, sort});
+      benchmark->Args({nodes, 1, 1, sort});
+    }
+  }
+  benchmark->Args({1000000, 0, 16, 0});
+  benchmark->Unit(benchmark::kMicrosecond);
+}
+BENCHMARK(BM_SortNodes)->Apply(sortArguments);
+
+// Time from a generated graph to the first finished wave: build, sort by
+// depth and run once. Pool is created before timing, as it outlives graphs
+// in an application rebuilding them on reconfiguration.
+// NOLINTNEXTLINE
+static void BM_FirstWaveSerial(benchmark::State &state) {
+  dag::GeneratedGraph graph = generateBuildGraph(state);
+  std::atomic<bool> stopFlag{false};
+  core::SerialCoreRunner runner{};
+
+  for (auto _ : state) {
+    dag::DynamicNodeList nodes{graph.getNumberOfNodes(), bytesPerNode(graph)};
+    dag::buildNodeList(graph, nodes);
+    nodes.sortNodes(dag::SortType::Depth);
+    runner.runNodeListSerialOnce(nodes, stopFlag);
+  }
+
+  setGraphCounters(state, graph);
+}
+BENCHMARK(BM_FirstWaveSerial)->Apply(buildArguments);
+
+// NOLINTNEXTLINE
+static void BM_FirstWaveParallel(benchmark::State &state) {
+  dag::GeneratedGraph graph = generateBuildGraph(state);
+  std::atomic<bool> stopFlag{false};
+  core::CoreThreadPool<numberOfThreads, poolQueueSize,
+                       threadPool::NoInstrumentation>
+      tPool{};
+  core::ParallelCoreRunner runner{};
+
+  for (auto _ : state) {
+    dag::DynamicNodeList nodes{graph.getNumberOfNodes(), bytesPerNode(graph)};
+    dag::buildNodeList(graph, nodes);
+    nodes.sortNodes(dag::SortType::Depth);
+    runner.runNodeListParallelOnce(nodes, tPool, stopFlag);
+  }
+
+  setGraphCounters(state, graph);
+}
+BENCHMARK(BM_FirstWaveParallel)
+    ->Apply(parallelBuildArguments)
+    ->UseRealTime();
+
+} // namespace baltazar
+
+BENCHMARK_MAIN();
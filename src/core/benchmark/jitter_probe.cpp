@@ -0,0 +1,182 @@
+#include "../../dag/dag_generator.hpp"
+#include "../../utils/log_linear_histogram.hpp"
+#include "../core_parallel.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Drives waves of a generated graph at a fixed rate, like a periodic control
+// loop, and prints the distribution of wave completion latency measured from
+// each period's release time. Waves finishing after the deadline are misses.
+// Waves are never skipped, so an overrun also shows up as late releases and
+// higher latency of the waves after it.
+//
+// Usage: baltazar_jitter_probe [--rate-hz 1000] [--waves 10000]
+//        [--deadline-us period] [--nodes 64] [--cost 500] [--load threads]
+namespace baltazar {
+
+constexpr size_t numberOfThreads = 4;
+constexpr size_t poolQueueSize = 256;
+
+using Clock = std::chrono::steady_clock;
+using LatencyHistogram = utils::LogLinearHistogram<5, 40>;
+
+struct JitterConfig {
+  double _rateHz{1000.0};
+  size_t _waves{10000};
+  std::int64_t _deadlineUs{0};
+  size_t _nodes{64};
+  std::uint64_t _cost{500};
+  size_t _loadThreads{0};
+};
+
+struct JitterResult {
+  LatencyHistogram _latency;
+  size_t _misses{0};
+  size_t _lateReleases{0};
+};
+
+JitterConfig parseArguments(int argc, char **argv) {
+  JitterConfig config{};
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *flag = argv[i];
+    const char *value = argv[i + 1];
+    if (std::strcmp(flag, "--rate-hz") == 0) {
+      config._rateHz = std::atof(value);
+    } else if (std::strcmp(flag, "--waves") == 0) {
+      config._waves = std::strtoull(value, nullptr, 10);
+    } else if (std::strcmp(flag, "--deadline-us") == 0) {
+      config._deadlineUs = std::atoll(value);
+    } else if (std::strcmp(flag, "--nodes") == 0) {
+      config._nodes = std::strtoull(value, nullptr, 10);
+    } else if (std::strcmp(flag, "--cost") == 0) {
+      config._cost = std::strtoull(value, nullptr, 10);
+    } else if (std::strcmp(flag, "--load") == 0) {
+      config._loadThreads = std::strtoull(value, nullptr, 10);
+    } else {
+      std::fprintf(stderr, "Unknown flag %s\n", flag);
+    }
+  }
+  return config;
+}
+
+// Busy threads competing with workers for CPU time.
+class LoadGenerator {
+public:
+  explicit LoadGenerator(size_t numberOfThreads) {
+    for (size_t i = 0; i < numberOfThreads; i++) {
+      m_threads.emplace_back([this, i] {
+        std::uint64_t value = i;
+        while (!m_stop.load(std::memory_order_relaxed)) {
+          value = dag::generatedWork(value, 1000);
+        }
+        m_sink.fetch_add(value, std::memory_order_relaxed);
+      });
+    }
+  }
+
+  LoadGenerator(const LoadGenerator &other) = delete;
+  LoadGenerator(LoadGenerator &&other) = delete;
+
+  ~LoadGenerator() {
+    m_stop = true;
+    for (auto &thread : m_threads) {
+      thread.join();
+    }
+  }
+
+private:
+  std::vector<std::thread> m_threads;
+  std::atomic<bool> m_stop{false};
+  std::atomic<std::uint64_t> m_sink{0};
+};
+
+JitterResult runPeriodicLoop(const JitterConfig &config) {
+  dag::GraphSpec spec{};
+  spec._numberOfNodes = config._nodes;
+  spec._width = 8;
+  spec._maxFanIn = 2;
+  spec._cost = dag::CostDistribution::Uniform;
+  spec._meanCost = config._cost;
+  dag::GeneratedGraph graph = dag::generateGraph(spec);
+  dag::DynamicNodeList nodes{graph.getNumberOfNodes()};
+  dag::buildNodeList(graph, nodes);
+  nodes.sortNodes(dag::SortType::Depth);
+
+  std::atomic<bool> stopFlag{false};
+  core::CoreThreadPool<numberOfThreads, poolQueueSize,
+                       threadPool::NoInstrumentation>
+      tPool{};
+  core::ParallelCoreRunner runner{};
+
+  const auto period = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1.0 / config._rateHz));
+  const auto deadline = config._deadlineUs > 0
+                            ? std::chrono::duration_cast<Clock::duration>(
+                                  std::chrono::microseconds(config._deadlineUs))
+                            : period;
+
+  JitterResult result{};
+  // Warm up pool threads and caches before measuring.
+  runner.runNodeListParallelNTimes(nodes, tPool, stopFlag, 10);
+
+  auto release = Clock::now() + period;
+  for (size_t wave = 0; wave < config._waves; wave++) {
+    if (Clock::now() > release) {
+      result._lateReleases++;
+    }
+    std::this_thread::sleep_until(release);
+
+    runner.runNodeListParallelOnce(nodes, tPool, stopFlag);
+
+    auto latency = Clock::now() - release;
+    result._latency.record(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(latency)
+            .count()));
+    if (latency > deadline) {
+      result._misses++;
+    }
+    release += period;
+  }
+
+  return result;
+}
+
+void printResult(const JitterConfig &config, const JitterResult &result) {
+  const LatencyHistogram &latency = result._latency;
+  auto us = [](std::uint64_t ns) { return static_cast<double>(ns) / 1e3; };
+
+  std::printf("rate %.1f Hz, %zu waves, %zu nodes, %zu load threads\n",
+              config._rateHz, config._waves, config._nodes,
+              config._loadThreads);
+  std::printf("latency p50 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n",
+              us(latency.valueAtPercentile(50.0)),
+              us(latency.valueAtPercentile(99.0)),
+              us(latency.valueAtPercentile(99.9)), us(latency.getMax()));
+  std::printf("deadline misses %zu (%.3f%%), late releases %zu\n",
+              result._misses,
+              100.0 * static_cast<double>(result._misses) /
+                  static_cast<double>(config._waves),
+              result._lateReleases);
+}
+
+} // namespace baltazar
+
+int main(int argc, char **argv) {
+  baltazar::JitterConfig config = baltazar::parseArguments(argc, argv);
+  if (config._rateHz <= 0.0 || config._waves == 0 || config._nodes == 0) {
+    std::fprintf(stderr, "Rate, waves and nodes must be positive.\n");
+    return 1;
+  }
+
+  baltazar::LoadGenerator load{config._loadThreads};
+  baltazar::JitterResult result = baltazar::runPeriodicLoop(config);
+  baltazar::printResult(config, result);
+  return 0;
+}
@@ -0,0 +1,358 @@
+#include "../../dag/dag_generator.hpp"
+#include "../binary_trace.hpp"
+#include "../core_parallel.hpp"
+#include "../core_serial.hpp"
+#include "../histogram_profiling.hpp"
+#include "../lock_free_profiling.hpp"
+#include "../multithreaded_profiling.hpp"
+#include "../profiling.hpp"
+#include "../sampled_profiling.hpp"
+
+#include <array>
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+
+// Heap traffic of steady state waves and memory footprint of large graphs.
+// Global operator new and delete are replaced with counting versions, which
+// see allocations of every thread including pool workers and profiler
+// threads. Per wave counters are taken after warm up waves, so anything
+// non-zero is an allocation on the hot path.
+namespace {
+
+std::atomic<std::uint64_t> allocationCount{0};
+std::atomic<std::uint64_t> deallocationCount{0};
+std::atomic<std::uint64_t> allocatedBytes{0};
+
+void *countedAllocate(std::size_t size, std::size_t alignment) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+  size = size == 0 ? 1 : size;
+  void *ptr = nullptr;
+  if (alignment > alignof(std::max_align_t)) {
+    // aligned_alloc wants size to be a multiple of alignment.
+    ptr = std::aligned_alloc(alignment,
+                             (size + alignment - 1) / alignment * alignment);
+  } else {
+    ptr = std::malloc(size);
+  }
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void countedFree(void *ptr) {
+  if (ptr != nullptr) {
+    deallocationCount.fetch_add(1, std::memory_order_relaxed);
+    std::free(ptr);
+  }
+}
+
+} // namespace
+
+void *operator new(std::size_t size) {
+  return countedAllocate(size, alignof(std::max_align_t));
+}
+void *operator new[](std::size_t size) {
+  return countedAllocate(size, alignof(std::max_align_t));
+}
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+  return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void *ptr) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept {
+  countedFree(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+  countedFree(ptr);
+}
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+  countedFree(ptr);
+}
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+  countedFree(ptr);
+}
+
+namespace baltazar {
+
+constexpr size_t numberOfThreads = 4;
+constexpr size_t poolQueueSize = 256;
+constexpr size_t steadyGraphNodes = 256;
+constexpr size_t warmUpWaves = 20;
+
+struct AllocationStats {
+  std::uint64_t _allocations;
+  std::uint64_t _deallocations;
+  std::uint64_t _bytes;
+
+  static AllocationStats now() {
+    return {allocationCount.load(std::memory_order_relaxed),
+            deallocationCount.load(std::memory_order_relaxed),
+            allocatedBytes.load(std::memory_order_relaxed)};
+  }
+
+  AllocationStats operator-(const AllocationStats &other) const {
+    return {_allocations - other._allocations,
+            _deallocations - other._deallocations, _bytes - other._bytes};
+  }
+};
+
+void setPerWaveCounters(benchmark::State &state,
+                        const AllocationStats &stats) {
+  auto waves = static_cast<double>(state.iterations());
+  state.counters["allocs_per_wave"] =
+      static_cast<double>(stats._allocations) / waves;
+  state.counters["frees_per_wave"] =
+      static_cast<double>(stats._deallocations) / waves;
+  state.counters["bytes_per_wave"] = static_cast<double>(stats._bytes) / waves;
+}
+
+// Peak resident set size in kB, 0 where /proc is not available.
+std::uint64_t readPeakRssKb() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmHWM:", 0) == 0) {
+      return std::strtoull(line.c_str() + 6, nullptr, 10);
+    }
+  }
+  return 0;
+}
+
+dag::GeneratedGraph generateMemoryGraph(size_t numberOfNodes) {
+  dag::GraphSpec spec{};
+  spec._numberOfNodes = numberOfNodes;
+  spec._width = 16;
+  spec._maxFanIn = 3;
+  spec._meanCost = 16;
+  return dag::generateGraph(spec);
+}
+
+void buildGeneratedList(dag::DynamicNodeList &nodes, size_t numberOfNodes) {
+  dag::buildNodeList(generateMemoryGraph(numberOfNodes), nodes);
+  nodes.sortNodes(dag::SortType::Depth);
+}
+
+// Profiler output is thrown away, only its allocations matter.
+std::ofstream &nullOutput() {
+  static std::ofstream out("/dev/null");
+  return out;
+}
+
+template <typename PROFILER>
+// NOLINTNEXTLINE
+static void BM_SerialWaveAllocations(benchmark::State &state) {
+  dag::DynamicNodeList nodes{steadyGraphNodes};
+  buildGeneratedList(nodes, steadyGraphNodes);
+  std::atomic<bool> stopFlag{false};
+  core::SerialCoreRunner<PROFILER> runner{&nullOutput(), true};
+  runner.runNodeListSerialNTimes(nodes, stopFlag, warmUpWaves);
+
+  AllocationStats before = AllocationStats::now();
+  for (auto _ : state) {
+    runner.runNodeListSerialOnce(nodes, stopFlag);
+  }
+  setPerWaveCounters(state, AllocationStats::now() - before);
+}
+
+template <typename PROFILER>
+// NOLINTNEXTLINE
+static void BM_ParallelWaveAllocations(benchmark::State &state) {
+  dag::DynamicNodeList nodes{steadyGraphNodes};
+  buildGeneratedList(nodes, steadyGraphNodes);
+  std::atomic<bool> stopFlag{false};
+  core::CoreThreadPool<numberOfThreads, poolQueueSize,
+                       threadPool::RuntimeInstrumentation>
+      tPool{};
+  core::ParallelCoreRunner<PROFILER> runner{&nullOutput(), true};
+  runner.runNodeListParallelNTimes(nodes, tPool, stopFlag, warmUpWaves);
+
+  AllocationStats before = AllocationStats::now();
+  for (auto _ : state) {
+    runner.runNodeListParallelOnce(nodes, tPool, stopFlag);
+  }
+  setPerWaveCounters(state, AllocationStats::now() - before);
+}
+
+using HistogramProfiler = core::HistogramCoreProfiler<steadyGraphNodes>;
+
+#define BALTAZAR_WAVE_ALLOCATIONS(BM)                                          \
+  BENCHMARK_TEMPLATE(BM, core::NullProfiler)->UseRealTime();                   \
+  BENCHMARK_TEMPLATE(BM, core::SingleThreadedCoreProfiler<100>)                \
+      ->UseRealTime();                                                         \
+  BENCHMARK_TEMPLATE(BM, core::MultiThreadedCoreProfiler<100>)->UseRealTime(); \
+  BENCHMARK_TEMPLATE(BM, core::LockFreeCoreProfiler<1024>)->UseRealTime();     \
+  BENCHMARK_TEMPLATE(BM, HistogramProfiler)->UseRealTime();                    \
+  BENCHMARK_TEMPLATE(BM, core::BinaryTraceCoreProfiler<256>)->UseRealTime();   \
+  BENCHMARK_TEMPLATE(BM, core::SampledCoreProfiler<HistogramProfiler>)         \
+      ->UseRealTime()
+
+BALTAZAR_WAVE_ALLOCATIONS(BM_SerialWaveAllocations);
+BALTAZAR_WAVE_ALLOCATIONS(BM_ParallelWaveAllocations);
+
+// Graph of core_benchmark without the sleeps, so value types like strings
+// and structs pass between nodes.
+struct ExampleData {
+  int _first;
+  int _second;
+};
+
+class ExampleSum {
+public:
+  double operator()(int a, float b) {
+    return static_cast<double>(a) + static_cast<double>(b);
+  }
+};
+
+class ExampleInt {
+public:
+  int operator()() { return 2; }
+};
+
+class ExampleFloat {
+public:
+  float operator()() { return 3.f; }
+};
+
+class ExamplePair {
+public:
+  std::array<int, 2> operator()(ExampleData data, std::string s) {
+    return {data._first, data._second + static_cast<int>(s.size())};
+  }
+};
+
+class ExampleStruct {
+public:
+  ExampleData operator()() { return {2, 6}; }
+};
+
+class ExampleString {
+public:
+  std::string operator()() { return "mystring"; }
+};
+
+class ExampleAccumulate {
+public:
+  double operator()(double a, std::array<int, 2> b) {
+    m_sum += a + static_cast<double>(b[0] + b[1]);
+    return m_sum;
+  }
+
+private:
+  double m_sum{0.0};
+};
+
+struct ExampleGraph {
+  ExampleGraph()
+      : nodeA{ExampleSum{}, 1}, nodeB{ExampleInt{}, 2},
+        nodeC{ExampleFloat{}, 3}, nodeD{ExamplePair{}, 4},
+        nodeE{ExampleStruct{}, 5}, nodeF{ExampleString{}, 6},
+        nodeG{ExampleAccumulate{}, 7} {
+    nodeA.setDependencyAt<0>(nodeB);
+    nodeA.setDependencyAt<1>(nodeC);
+    nodeD.setDependencyAt<0>(nodeE);
+    nodeD.setDependencyAt<1>(nodeF);
+    nodeG.setDependencyAt<0>(nodeA);
+    nodeG.setDependencyAt<1>(nodeD);
+
+    nodes.addNode(&nodeA);
+    nodes.addNode(&nodeB);
+    nodes.addNode(&nodeC);
+    nodes.addNode(&nodeD);
+    nodes.addNode(&nodeE);
+    nodes.addNode(&nodeF);
+    nodes.addNode(&nodeG);
+    nodes.sortNodes(dag::SortType::Depth);
+  }
+
+  dag::Node<2, ExampleSum> nodeA;
+  dag::Node<0, ExampleInt> nodeB;
+  dag::Node<0, ExampleFloat> nodeC;
+  dag::Node<2, ExamplePair> nodeD;
+  dag::Node<0, ExampleStruct> nodeE;
+  dag::Node<0, ExampleString> nodeF;
+  dag::Node<2, ExampleAccumulate> nodeG;
+  dag::NodeList<7> nodes{};
+};
+
+// NOLINTNEXTLINE
+static void BM_ExampleGraphSerialAllocations(benchmark::State &state) {
+  ExampleGraph graph{};
+  std::atomic<bool> stopFlag{false};
+  core::SerialCoreRunner runner{};
+  runner.runNodeListSerialNTimes(graph.nodes, stopFlag, warmUpWaves);
+
+  AllocationStats before = AllocationStats::now();
+  for (auto _ : state) {
+    runner.runNodeListSerialOnce(graph.nodes, stopFlag);
+  }
+  setPerWaveCounters(state, AllocationStats::now() - before);
+}
+BENCHMARK(BM_ExampleGraphSerialAllocations);
+
+// NOLINTNEXTLINE
+static void BM_ExampleGraphParallelAllocations(benchmark::State &state) {
+  ExampleGraph graph{};
+  std::atomic<bool> stopFlag{false};
+  core::CoreThreadPool<numberOfThreads, poolQueueSize,
+                       threadPool::NoInstrumentation>
+      tPool{};
+  core::ParallelCoreRunner runner{};
+  runner.runNodeListParallelNTimes(graph.nodes, tPool, stopFlag, warmUpWaves);
+
+  AllocationStats before = AllocationStats::now();
+  for (auto _ : state) {
+    runner.runNodeListParallelOnce(graph.nodes, tPool, stopFlag);
+  }
+  setPerWaveCounters(state, AllocationStats::now() - before);
+}
+BENCHMARK(BM_ExampleGraphParallelAllocations)->UseRealTime();
+
+// Bytes allocated by the node list of a generated graph and peak RSS after
+// it. The graph is generated before measuring, so the generator's temporary
+// vectors aren't counted. VmHWM never goes down, so benchmarks run from small
+// to large graphs and the value of the largest one is the process peak.
+// NOLINTNEXTLINE
+static void BM_LargeGraphFootprint(benchmark::State &state) {
+  const auto numberOfNodes = static_cast<size_t>(state.range(0));
+  dag::GeneratedGraph graph = generateMemoryGraph(numberOfNodes);
+  AllocationStats beforeBuild = AllocationStats::now();
+  dag::DynamicNodeList nodes{numberOfNodes};
+  dag::buildNodeList(graph, nodes);
+  AllocationStats build = AllocationStats::now() - beforeBuild;
+  nodes.sortNodes(dag::SortType::Depth);
+
+  std::atomic<bool> stopFlag{false};
+  core::SerialCoreRunner runner{};
+  runner.runNodeListSerialOnce(nodes, stopFlag);
+
+  AllocationStats before = AllocationStats::now();
+  for (auto _ : state) {
+    runner.runNodeListSerialOnce(nodes, stopFlag);
+  }
+  setPerWaveCounters(state, AllocationStats::now() - before);
+
+  state.counters["build_bytes"] = static_cast<double>(build._bytes);
+  state.counters["bytes_per_node"] = static_cast<double>(build._bytes) /
+                                     static_cast<double>(numberOfNodes);
+  state.counters["peak_rss_kb"] = static_cast<double>(readPeakRssKb());
+}
+BENCHMARK(BM_LargeGraphFootprint)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace baltazar
+
+BENCHMARK_MAIN();
@@ -0,0 +1,183 @@
+#include "../../dag/dag_generator.hpp"
+#include "../../dag/dynamic_dag.hpp"
+#include "../core_parallel.hpp"
+#include "../core_serial.hpp"
+
+#include <array>
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+// Scheduling overhead with empty or nanosecond scale nodes. Node cost is the
+// first argument, in dag::generatedWork units (0 is an empty node); per_task
+// and per_wave counters are time per scheduled task and per wave.
+// Multithreaded benchmarks use wall time.
+namespace baltazar {
+
+constexpr size_t graphWidth = 8;
+constexpr size_t graphDepth = 8;
+constexpr size_t wavesPerIteration = 100;
+constexpr size_t poolBatch = 64;
+
+// Layers of graphWidth nodes, every node depends on two nodes of the
+// previous layer.
+void buildLayeredGraph(dag::DynamicNodeList &nodes, std::int64_t cost) {
+  std::array<dag::INode *, graphWidth> previous{};
+  for (size_t layer = 0; layer < graphDepth; layer++) {
+    std::array<dag::INode *, graphWidth> current{};
+    for (size_t i = 0; i < graphWidth; i++) {
+      size_t numberOfDeps = layer == 0 ? 0 : 2;
+      auto *node = nodes.emplaceNode(
+          dag::GeneratedTask{static_cast<std::uint64_t>(cost)},
+          layer * graphWidth + i, numberOfDeps);
+      if (layer > 0) {
+        node->setDependencyAt(0, *previous[i]);
+        node->setDependencyAt(1, *previous[(i + 1) % graphWidth]);
+      }
+      current[i] = node;
+    }
+    previous = current;
+  }
+  nodes.sortNodes(dag::SortType::Depth);
+}
+
+void setOverheadCounters(benchmark::State &state, size_t tasks, size_t waves) {
+  auto totalTasks = static_cast<double>(state.iterations() * tasks);
+  auto totalWaves = static_cast<double>(state.iterations() * waves);
+  state.SetItemsProcessed(static_cast<std::int64_t>(totalTasks));
+  state.counters["per_task"] = benchmark::Counter(
+      totalTasks, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+  if (waves > 0) {
+    state.counters["per_wave"] = benchmark::Counter(
+        totalWaves, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+  }
+}
+
+class SpinTask final : public threadPool::IThreadTask {
+public:
+  explicit SpinTask(std::int64_t cost)
+      : m_cost(static_cast<std::uint64_t>(cost)) {}
+
+  void run() const override {
+    benchmark::DoNotOptimize(dag::generatedWork(m_identifier, m_cost));
+  }
+
+  size_t getIdentifier() const override { return m_identifier; }
+
+private:
+  std::uint64_t m_cost;
+  size_t m_identifier{0};
+};
+
+// Synced, so the batch is collected with getNextDoneTask().
+template <typename INSTRUMENTATION>
+threadPool::BasicThreadJob<INSTRUMENTATION>
+syncedJob(threadPool::IThreadTask &task, size_t id) {
+  threadPool::BasicThreadJob<INSTRUMENTATION> job{};
+  job._task = &task;
+  job._id = id;
+  job._shouldSyncWhenDone = true;
+  return job;
+}
+
+// Round trip of a batch through the pool: schedule, run and collect.
+template <size_t THREADS, typename INSTRUMENTATION>
+// NOLINTNEXTLINE
+static void BM_ThreadPoolRoundTrip(benchmark::State &state) {
+  SpinTask task{state.range(0)};
+  threadPool::ThreadPool<THREADS, poolBatch,
+                         threadPool::BasicThreadJob<INSTRUMENTATION>>
+      tPool{};
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < poolBatch; i++) {
+      tPool.scheduleTask(syncedJob<INSTRUMENTATION>(task, i));
+    }
+    for (size_t i = 0; i < poolBatch; i++) {
+      benchmark::DoNotOptimize(tPool.getNextDoneTask());
+    }
+  }
+
+  setOverheadCounters(state, poolBatch, 0);
+}
+BENCHMARK_TEMPLATE(BM_ThreadPoolRoundTrip, 1, threadPool::NoInstrumentation)
+    ->Arg(0)
+    ->Arg(256)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ThreadPoolRoundTrip, 2, threadPool::NoInstrumentation)
+    ->Arg(0)
+    ->Arg(256)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ThreadPoolRoundTrip, 4, threadPool::NoInstrumentation)
+    ->Arg(0)
+    ->Arg(256)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ThreadPoolRoundTrip, 8, threadPool::NoInstrumentation)
+    ->Arg(0)
+    ->Arg(256)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ThreadPoolRoundTrip, 4,
+                   threadPool::RuntimeInstrumentation)
+    ->Arg(0)
+    ->Arg(256)
+    ->UseRealTime();
+
+// NOLINTNEXTLINE
+static void BM_SerialRunnerOverhead(benchmark::State &state) {
+  dag::DynamicNodeList nodes{graphWidth * graphDepth};
+  buildLayeredGraph(nodes, state.range(0));
+  std::atomic<bool> stopFlag{false};
+  core::SerialCoreRunner runner{};
+
+  for (auto _ : state) {
+    runner.runNodeListSerialNTimes(nodes, stopFlag, wavesPerIteration);
+  }
+
+  setOverheadCounters(state, nodes.getNumberOfNodes() * wavesPerIteration,
+                      wavesPerIteration);
+}
+BENCHMARK(BM_SerialRunnerOverhead)->Arg(0)->Arg(256);
+
+template <size_t THREADS, typename INSTRUMENTATION>
+// NOLINTNEXTLINE
+static void BM_ParallelRunnerOverhead(benchmark::State &state) {
+  dag::DynamicNodeList nodes{graphWidth * graphDepth};
+  buildLayeredGraph(nodes, state.range(0));
+  std::atomic<bool> stopFlag{false};
+  core::CoreThreadPool<THREADS, graphWidth * graphDepth, INSTRUMENTATION>
+      tPool{};
+  core::ParallelCoreRunner runner{};
+
+  for (auto _ : state) {
+    runner.runNodeListParallelNTimes(nodes, tPool, stopFlag,
+                                     wavesPerIteration);
+  }
+
+  setOverheadCounters(state, nodes.getNumberOfNodes() * wavesPerIteration,
+                      wavesPerIteration);
+}
+BENCHMARK_TEMPLATE(BM_ParallelRunnerOverhead, 1, threadPool::NoInstrumentation)
+    ->Arg(0)
+    ->Arg(256)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ParallelRunnerOverhead, 2, threadPool::NoInstrumentation)
+    ->Arg(0)
+    ->Arg(256)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ParallelRunnerOverhead, 4, threadPool::NoInstrumentation)
+    ->Arg(0)
+    ->Arg(256)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ParallelRunnerOverhead, 8, threadPool::NoInstrumentation)
+    ->Arg(0)
+    ->Arg(256)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ParallelRunnerOverhead, 4,
+                   threadPool::RuntimeInstrumentation)
+    ->Arg(0)
+    ->Arg(256)
+    ->UseRealTime();
+
+} // namespace baltazar
+
+BENCHMARK_MAIN();
@@ -0,0 +1,214 @@
+#include "../../dag/dag_generator.hpp"
+#include "../binary_trace.hpp"
+#include "../core_parallel.hpp"
+#include "../core_serial.hpp"
+#include "../histogram_profiling.hpp"
+#include "../lock_free_profiling.hpp"
+#include "../multithreaded_profiling.hpp"
+#include "../profiling.hpp"
+#include "../sampled_profiling.hpp"
+
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+
+// Same generated graph run with every profiler. Arguments are node cost in
+// generatedWork units (0 is a no-op node) and whether the profiler is turned
+// on. Profiling is compiled out with NullProfiler and a NoInstrumentation
+// pool; a profiler that is compiled in but turned off shows the cost of the
+// runtime switch. Each benchmark first times the same graph without any
+// profiling and reports overhead relative to it. Events are jobs and waves
+// offered to the profiler; sampled profilers forward only part of them.
+namespace baltazar {
+
+constexpr size_t numberOfThreads = 4;
+constexpr size_t poolQueueSize = 256;
+constexpr size_t graphNodes = 256;
+constexpr auto minBaselineTime = std::chrono::milliseconds(20);
+
+using HistogramProfiler = core::HistogramCoreProfiler<graphNodes>;
+using SampledProfiler = core::SampledCoreProfiler<HistogramProfiler>;
+
+void buildProfiledGraph(dag::DynamicNodeList &nodes, std::uint64_t cost) {
+  dag::GraphSpec spec{};
+  spec._numberOfNodes = graphNodes;
+  spec._width = 16;
+  spec._maxFanIn = 3;
+  spec._meanCost = cost;
+  dag::buildNodeList(dag::generateGraph(spec), nodes);
+  nodes.sortNodes(dag::SortType::Depth);
+}
+
+// Profiler output is thrown away, writing it is still part of the cost.
+std::ofstream &nullOutput() {
+  static std::ofstream out("/dev/null");
+  return out;
+}
+
+template <typename PROFILER> void configureProfiler(PROFILER & /*profiler*/) {}
+
+// Sampling every wave would make it a slower histogram profiler.
+void configureProfiler(SampledProfiler &profiler) {
+  profiler.setSamplingConfig({10, 1.0, core::microsecs{0}});
+}
+
+template <typename RUN_WAVE> double measureWaveNs(RUN_WAVE &&runWave) {
+  size_t waves = 0;
+  auto start = std::chrono::steady_clock::now();
+  auto elapsed = std::chrono::steady_clock::duration::zero();
+  while (waves < 3 || elapsed < minBaselineTime) {
+    runWave();
+    waves++;
+    elapsed = std::chrono::steady_clock::now() - start;
+  }
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                 .count()) /
+         static_cast<double>(waves);
+}
+
+void setProfilerCounters(benchmark::State &state, double baselineWaveNs,
+                         double waveNs, size_t eventsPerWave) {
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(graphNodes));
+  state.counters["baseline_wave_us"] = baselineWaveNs / 1e3;
+  state.counters["overhead_pct"] =
+      (waveNs - baselineWaveNs) / baselineWaveNs * 100.0;
+  state.counters["events"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * eventsPerWave),
+      benchmark::Counter::kIsRate);
+}
+
+double elapsedWaveNs(const benchmark::State &state,
+                     std::chrono::steady_clock::time_point start) {
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now() - start)
+                 .count()) /
+         static_cast<double>(state.iterations());
+}
+
+template <typename PROFILER>
+// NOLINTNEXTLINE
+static void BM_SerialProfilerOverhead(benchmark::State &state) {
+  const bool profilerOn = state.range(1) != 0;
+  dag::DynamicNodeList nodes{graphNodes};
+  buildProfiledGraph(nodes, static_cast<std::uint64_t>(state.range(0)));
+  std::atomic<bool> stopFlag{false};
+
+  core::SerialCoreRunner baselineRunner{};
+  double baselineWaveNs = measureWaveNs(
+      [&] { baselineRunner.runNodeListSerialOnce(nodes, stopFlag); });
+
+  core::SerialCoreRunner<PROFILER> runner{&nullOutput(), profilerOn};
+  configureProfiler(runner.getProfiler());
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    runner.runNodeListSerialOnce(nodes, stopFlag);
+  }
+  double waveNs = elapsedWaveNs(state, start);
+
+  bool logged = decltype(runner)::profilingEnabled && profilerOn;
+  setProfilerCounters(state, baselineWaveNs, waveNs,
+                      logged ? graphNodes + 1 : 0);
+}
+
+// Jobs are only timestamped and logged with an instrumented pool.
+template <typename PROFILER, typename INSTRUMENTATION>
+// NOLINTNEXTLINE
+static void BM_ParallelProfilerOverhead(benchmark::State &state) {
+  const bool profilerOn = state.range(1) != 0;
+  dag::DynamicNodeList nodes{graphNodes};
+  buildProfiledGraph(nodes, static_cast<std::uint64_t>(state.range(0)));
+  std::atomic<bool> stopFlag{false};
+
+  double baselineWaveNs = 0.0;
+  {
+    core::CoreThreadPool<numberOfThreads, poolQueueSize,
+                         threadPool::NoInstrumentation>
+        baselinePool{};
+    core::ParallelCoreRunner baselineRunner{};
+    baselineWaveNs = measureWaveNs([&] {
+      baselineRunner.runNodeListParallelOnce(nodes, baselinePool, stopFlag);
+    });
+  }
+
+  core::CoreThreadPool<numberOfThreads, poolQueueSize, INSTRUMENTATION>
+      tPool{};
+  core::ParallelCoreRunner<PROFILER> runner{&nullOutput(), profilerOn};
+  configureProfiler(runner.getProfiler());
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    runner.runNodeListParallelOnce(nodes, tPool, stopFlag);
+  }
+  double waveNs = elapsedWaveNs(state, start);
+
+  bool logged = decltype(runner)::profilingEnabled && profilerOn;
+  size_t jobEvents = INSTRUMENTATION::enabled ? graphNodes : 0;
+  setProfilerCounters(state, baselineWaveNs, waveNs,
+                      logged ? jobEvents + 1 : 0);
+}
+
+void profilerArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"cost", "on"});
+  for (std::int64_t cost : {0, 2000}) {
+    benchmark->Args({cost, 0});
+    benchmark->Args({cost, 1});
+  }
+  benchmark->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
+
+BENCHMARK_TEMPLATE(BM_SerialProfilerOverhead, core::NullProfiler)
+    ->Apply(profilerArguments);
+BENCHMARK_TEMPLATE(BM_SerialProfilerOverhead,
+                   core::SingleThreadedCoreProfiler<100>)
+    ->Apply(profilerArguments);
+BENCHMARK_TEMPLATE(BM_SerialProfilerOverhead,
+                   core::MultiThreadedCoreProfiler<100>)
+    ->Apply(profilerArguments);
+BENCHMARK_TEMPLATE(BM_SerialProfilerOverhead, core::LockFreeCoreProfiler<1024>)
+    ->Apply(profilerArguments);
+BENCHMARK_TEMPLATE(BM_SerialProfilerOverhead, HistogramProfiler)
+    ->Apply(profilerArguments);
+BENCHMARK_TEMPLATE(BM_SerialProfilerOverhead,
+                   core::BinaryTraceCoreProfiler<256>)
+    ->Apply(profilerArguments);
+BENCHMARK_TEMPLATE(BM_SerialProfilerOverhead, SampledProfiler)
+    ->Apply(profilerArguments);
+
+BENCHMARK_TEMPLATE(BM_ParallelProfilerOverhead, core::NullProfiler,
+                   threadPool::NoInstrumentation)
+    ->Apply(profilerArguments);
+BENCHMARK_TEMPLATE(BM_ParallelProfilerOverhead, core::NullProfiler,
+                   threadPool::RuntimeInstrumentation)
+    ->Apply(profilerArguments);
+BENCHMARK_TEMPLATE(BM_ParallelProfilerOverhead,
+                   core::SingleThreadedCoreProfiler<100>,
+                   threadPool::RuntimeInstrumentation)
+    ->Apply(profilerArguments);
+BENCHMARK_TEMPLATE(BM_ParallelProfilerOverhead,
+                   core::MultiThreadedCoreProfiler<100>,
+                   threadPool::RuntimeInstrumentation)
+    ->Apply(profilerArguments);
+BENCHMARK_TEMPLATE(BM_ParallelProfilerOverhead,
+                   core::LockFreeCoreProfiler<1024>,
+                   threadPool::RuntimeInstrumentation)
+    ->Apply(profilerArguments);
+BENCHMARK_TEMPLATE(BM_ParallelProfilerOverhead, HistogramProfiler,
+                   threadPool::RuntimeInstrumentation)
+    ->Apply(profilerArguments);
+BENCHMARK_TEMPLATE(BM_ParallelProfilerOverhead,
+                   core::BinaryTraceCoreProfiler<256>,
+                   threadPool::RuntimeInstrumentation)
+    ->Apply(profilerArguments);
+BENCHMARK_TEMPLATE(BM_ParallelProfilerOverhead, SampledProfiler,
+                   threadPool::RuntimeInstrumentation)
+    ->Apply(profilerArguments);
+
+} // namespace baltazar
+
+BENCHMARK_MAIN();
@@ -0,0 +1,111 @@
+#include "../../dag/dag_generator.hpp"
+#include "../core_parallel.hpp"
+#include "../core_serial.hpp"
+
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+// Generated graphs swept over size, shape and thread count. Every benchmark
+// first times the same graph with SerialCoreRunner and reports speedup over it
+// and parallel efficiency (speedup / threads). Shape argument is the
+// dag::GraphShape value: 0 layered, 1 wide fan-out, 2 deep chain, 3 diamond,
+// 4 random.
+namespace baltazar {
+
+constexpr std::uint64_t meanNodeCost = 1000;
+constexpr size_t poolQueueSize = 256;
+// Longest deep chain run in parallel, see README.
+constexpr std::int64_t maxChainNodes = 10000;
+constexpr auto minSerialTime = std::chrono::milliseconds(20);
+
+dag::GraphSpec makeSpec(const benchmark::State &state) {
+  dag::GraphSpec spec{};
+  spec._numberOfNodes = static_cast<size_t>(state.range(0));
+  spec._shape = static_cast<dag::GraphShape>(state.range(1));
+  spec._width = std::max<size_t>(
+      1, static_cast<size_t>(std::sqrt(spec._numberOfNodes)));
+  spec._maxFanIn = 3;
+  spec._edgeProbability = 4.0 / static_cast<double>(spec._numberOfNodes);
+  spec._cost = dag::CostDistribution::Uniform;
+  spec._meanCost = meanNodeCost;
+  spec._seed = 42;
+  return spec;
+}
+
+double measureSerialWaveNs(dag::DynamicNodeList &nodes) {
+  std::atomic<bool> stopFlag{false};
+  core::SerialCoreRunner runner{};
+  size_t waves = 0;
+  auto start = std::chrono::steady_clock::now();
+  auto elapsed = std::chrono::steady_clock::duration::zero();
+  while (waves < 3 || elapsed < minSerialTime) {
+    runner.runNodeListSerialOnce(nodes, stopFlag);
+    waves++;
+    elapsed = std::chrono::steady_clock::now() - start;
+  }
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                 .count()) /
+         static_cast<double>(waves);
+}
+
+template <size_t THREADS>
+// NOLINTNEXTLINE
+static void BM_ScaleGeneratedGraph(benchmark::State &state) {
+  dag::GraphSpec spec = makeSpec(state);
+  dag::GeneratedGraph graph = dag::generateGraph(spec);
+  dag::DynamicNodeList nodes{graph.getNumberOfNodes()};
+  dag::buildNodeList(graph, nodes);
+  nodes.sortNodes(dag::SortType::Depth);
+  double serialWaveNs = measureSerialWaveNs(nodes);
+
+  std::atomic<bool> stopFlag{false};
+  core::CoreThreadPool<THREADS, poolQueueSize,
+                       threadPool::NoInstrumentation>
+      tPool{};
+  core::ParallelCoreRunner runner{};
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    runner.runNodeListParallelOnce(nodes, tPool, stopFlag);
+  }
+  double parallelWaveNs =
+      static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - start)
+                              .count()) /
+      static_cast<double>(state.iterations());
+
+  double speedup = serialWaveNs / parallelWaveNs;
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(graph.getNumberOfNodes()));
+  state.counters["edges"] = static_cast<double>(graph.getNumberOfEdges());
+  state.counters["serial_wave_us"] = serialWaveNs / 1e3;
+  state.counters["speedup"] = speedup;
+  state.counters["efficiency"] = speedup / static_cast<double>(THREADS);
+}
+
+void scalingArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"nodes", "shape"});
+  for (std::int64_t shape = 0;
+       shape <= static_cast<std::int64_t>(dag::GraphShape::Random); shape++) {
+    for (std::int64_t nodes = 10; nodes <= 100000; nodes *= 10) {
+      if (shape != static_cast<std::int64_t>(dag::GraphShape::DeepChain) ||
+          nodes <= maxChainNodes) {
+        benchmark->Args({nodes, shape});
+      }
+    }
+  }
+  benchmark->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
+
+BENCHMARK_TEMPLATE(BM_ScaleGeneratedGraph, 1)->Apply(scalingArguments);
+BENCHMARK_TEMPLATE(BM_ScaleGeneratedGraph, 2)->Apply(scalingArguments);
+BENCHMARK_TEMPLATE(BM_ScaleGeneratedGraph, 4)->Apply(scalingArguments);
+BENCHMARK_TEMPLATE(BM_ScaleGeneratedGraph, 8)->Apply(scalingArguments);
+
+} // namespace baltazar
+
+BENCHMARK_MAIN();
@@ -0,0 +1,401 @@
+#include "../../dag/dynamic_dag.hpp"
+#include "../core_parallel.hpp"
+#include "../core_serial.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Graphs of real compute kernels instead of sleeps, so workers compete for
+// caches and memory bandwidth. Workload argument is:
+// 0 tiled image pipeline: 3x3 box blur, gain and 64 bin histogram per band of
+//   rows, merged into one histogram. About 0.5 flop/byte.
+// 1 reduction tree: sum of squares over leaf chunks of a double array,
+//   combined pairwise. 0.25 flop/byte.
+// 2 string parsing fan-out: a splitter finds line aligned chunks of CSV text
+//   and every chunk is parsed into integers by its own node. No flops.
+// Items are pixels, array elements and text lines; bytes are what the
+// kernels read and write per wave.
+namespace baltazar {
+
+constexpr size_t poolQueueSize = 256;
+constexpr size_t workloadCapacity = 256;
+constexpr size_t imageWidth = 1024;
+constexpr size_t imageHeight = 1024;
+constexpr size_t imageBands = 64;
+constexpr size_t histogramBins = 64;
+constexpr size_t reductionElements = 1UL << 21UL;
+constexpr size_t reductionLeaves = 64;
+constexpr size_t textLines = 1UL << 17UL;
+constexpr size_t textChunks = 64;
+
+enum class Workload { ImagePipeline, ReductionTree, StringParsing };
+
+// Inputs and intermediate buffers, nodes keep pointers into it.
+struct WorkloadData {
+  std::vector<float> _source;
+  std::vector<float> _filtered;
+  std::vector<double> _values;
+  std::string _text;
+  std::int64_t _items{0};
+  std::int64_t _bytes{0};
+  double _flopsPerByte{0.0};
+};
+
+using Histogram = std::array<std::uint32_t, histogramBins>;
+
+class BlurBand {
+public:
+  BlurBand(const WorkloadData &data, float *out, size_t firstRow,
+           size_t lastRow)
+      : m_source(data._source.data()), m_out(out), m_firstRow(firstRow),
+        m_lastRow(lastRow) {}
+
+  // Rows outside the image are clamped to the edge.
+  bool operator()() {
+    for (size_t y = m_firstRow; y < m_lastRow; y++) {
+      std::array<const float *, 3> rows{
+          row(y == 0 ? 0 : y - 1), row(y),
+          row(std::min(y + 1, imageHeight - 1))};
+      for (size_t x = 0; x < imageWidth; x++) {
+        size_t left = x == 0 ? 0 : x - 1;
+        size_t right = std::min(x + 1, imageWidth - 1);
+        float sum = 0.f;
+        for (const float *r : rows) {
+          sum += r[left] + r[x] + r[right];
+        }
+        m_out[y * imageWidth + x] = sum * (1.f / 9.f);
+      }
+    }
+    return true;
+  }
+
+private:
+  const float *row(size_t y) const { return m_source + y * imageWidth; }
+
+  const float *m_source;
+  float *m_out;
+  size_t m_firstRow;
+  size_t m_lastRow;
+};
+
+class GainBand {
+public:
+  GainBand(float *pixels, size_t count) : m_pixels(pixels), m_count(count) {}
+
+  bool operator()(bool) {
+    for (size_t i = 0; i < m_count; i++) {
+      m_pixels[i] = std::clamp(m_pixels[i] * 1.2f - 0.1f, 0.f, 1.f);
+    }
+    return true;
+  }
+
+private:
+  float *m_pixels;
+  size_t m_count;
+};
+
+class HistogramBand {
+public:
+  HistogramBand(const float *pixels, size_t count)
+      : m_pixels(pixels), m_count(count) {}
+
+  Histogram operator()(bool) {
+    Histogram histogram{};
+    for (size_t i = 0; i < m_count; i++) {
+      auto bin = static_cast<size_t>(m_pixels[i] * (histogramBins - 1));
+      histogram[bin]++;
+    }
+    return histogram;
+  }
+
+private:
+  const float *m_pixels;
+  size_t m_count;
+};
+
+class MergeHistograms {
+public:
+  Histogram operator()(dag::InputSpan<Histogram> bands) {
+    Histogram total{};
+    for (size_t i = 0; i < bands.size(); i++) {
+      for (size_t bin = 0; bin < histogramBins; bin++) {
+        total[bin] += bands[i][bin];
+      }
+    }
+    return total;
+  }
+};
+
+void buildImagePipeline(WorkloadData &data, dag::DynamicNodeList &nodes) {
+  const size_t pixels = imageWidth * imageHeight;
+  data._source.resize(pixels);
+  data._filtered.resize(pixels);
+  for (size_t i = 0; i < pixels; i++) {
+    data._source[i] = static_cast<float>((i * 2654435761UL) % 1024UL) / 1024.f;
+  }
+
+  const size_t rowsPerBand = imageHeight / imageBands;
+  std::vector<dag::INode *> histograms;
+  size_t identifier = 0;
+  for (size_t band = 0; band < imageBands; band++) {
+    size_t firstRow = band * rowsPerBand;
+    float *bandPixels = data._filtered.data() + firstRow * imageWidth;
+    size_t bandSize = rowsPerBand * imageWidth;
+
+    auto *blur = nodes.emplaceNode(
+        BlurBand{data, data._filtered.data(), firstRow, firstRow + rowsPerBand},
+        identifier++);
+    auto *gain =
+        nodes.emplaceNode(GainBand{bandPixels, bandSize}, identifier++);
+    gain->setDependencyAt(0, *blur);
+    auto *histogram =
+        nodes.emplaceNode(HistogramBand{bandPixels, bandSize}, identifier++);
+    histogram->setDependencyAt(0, *gain);
+    histograms.push_back(histogram);
+  }
+
+  auto *merge =
+      nodes.emplaceNode(MergeHistograms{}, identifier++, histograms.size());
+  for (size_t i = 0; i < histograms.size(); i++) {
+    merge->setDependencyAt(i, *histograms[i]);
+  }
+
+  // Blur reads 3 rows and writes one, gain reads and writes, histogram
+  // reads. Blur is 9 adds and a multiply, gain a multiply-add and a clamp.
+  data._items = static_cast<std::int64_t>(pixels);
+  data._bytes = static_cast<std::int64_t>(pixels * sizeof(float) * 7);
+  data._flopsPerByte = 13.0 / (7.0 * sizeof(float));
+}
+
+class SumOfSquares {
+public:
+  SumOfSquares(const double *values, size_t count)
+      : m_values(values), m_count(count) {}
+
+  double operator()() {
+    double sum = 0.0;
+    for (size_t i = 0; i < m_count; i++) {
+      sum += m_values[i] * m_values[i];
+    }
+    return sum;
+  }
+
+private:
+  const double *m_values;
+  size_t m_count;
+};
+
+class AddPair {
+public:
+  double operator()(double left, double right) { return left + right; }
+};
+
+void buildReductionTree(WorkloadData &data, dag::DynamicNodeList &nodes) {
+  data._values.resize(reductionElements);
+  for (size_t i = 0; i < reductionElements; i++) {
+    data._values[i] = static_cast<double>(i % 1000UL) * 1e-3;
+  }
+
+  const size_t chunk = reductionElements / reductionLeaves;
+  std::vector<dag::INode *> level;
+  size_t identifier = 0;
+  for (size_t leaf = 0; leaf < reductionLeaves; leaf++) {
+    level.push_back(nodes.emplaceNode(
+        SumOfSquares{data._values.data() + leaf * chunk, chunk},
+        identifier++));
+  }
+
+  while (level.size() > 1) {
+    std::vector<dag::INode *> next;
+    for (size_t i = 0; i < level.size(); i += 2) {
+      auto *pair = nodes.emplaceNode(AddPair{}, identifier++);
+      pair->setDependencyAt(0, *level[i]);
+      pair->setDependencyAt(1, *level[i + 1]);
+      next.push_back(pair);
+    }
+    level = next;
+  }
+
+  data._items = static_cast<std::int64_t>(reductionElements);
+  data._bytes = static_cast<std::int64_t>(reductionElements * sizeof(double));
+  data._flopsPerByte = 2.0 / sizeof(double);
+}
+
+struct TextRange {
+  size_t _begin;
+  size_t _end;
+};
+
+struct ParseResult {
+  std::uint64_t _lines;
+  std::uint64_t _sum;
+};
+
+// Output vector is reused between waves, so splitting doesn't allocate.
+class SplitText {
+public:
+  explicit SplitText(const std::string &text) : m_text(&text) {}
+
+  void operator()(std::vector<TextRange> &ranges) {
+    ranges.clear();
+    size_t begin = 0;
+    for (size_t chunk = 1; chunk <= textChunks; chunk++) {
+      size_t end = m_text->size() * chunk / textChunks;
+      end = std::min(m_text->find('\n', end), m_text->size());
+      end = end < m_text->size() ? end + 1 : end;
+      ranges.push_back({begin, std::max(begin, end)});
+      begin = std::max(begin, end);
+    }
+  }
+
+private:
+  const std::string *m_text;
+};
+
+// Parses "id,value,name" lines and sums ids and values.
+class ParseChunk {
+public:
+  ParseChunk(const std::string &text, size_t chunk)
+      : m_text(&text), m_chunk(chunk) {}
+
+  ParseResult operator()(const std::vector<TextRange> &ranges) {
+    ParseResult result{};
+    const TextRange &range = ranges[m_chunk];
+    std::uint64_t field = 0;
+    size_t column = 0;
+    for (size_t i = range._begin; i < range._end; i++) {
+      char c = (*m_text)[i];
+      if (c >= '0' && c <= '9' && column < 2) {
+        field = field * 10 + static_cast<std::uint64_t>(c - '0');
+      } else if (c == ',') {
+        result._sum += field;
+        field = 0;
+        column++;
+      } else if (c == '\n') {
+        result._lines++;
+        field = 0;
+        column = 0;
+      }
+    }
+    return result;
+  }
+
+private:
+  const std::string *m_text;
+  size_t m_chunk;
+};
+
+class SumResults {
+public:
+  ParseResult operator()(dag::InputSpan<ParseResult> chunks) {
+    ParseResult total{};
+    for (size_t i = 0; i < chunks.size(); i++) {
+      total._lines += chunks[i]._lines;
+      total._sum += chunks[i]._sum;
+    }
+    return total;
+  }
+};
+
+void buildStringParsing(WorkloadData &data, dag::DynamicNodeList &nodes) {
+  for (size_t line = 0; line < textLines; line++) {
+    data._text += std::to_string(line) + "," +
+                  std::to_string((line * 7919UL) % 100000UL) + ",item" +
+                  std::to_string(line % 97UL) + "\n";
+  }
+
+  size_t identifier = 0;
+  auto *split = nodes.emplaceNode<dag::ReuseOutput>(SplitText{data._text},
+                                                    identifier++);
+  auto *sum = nodes.emplaceNode(SumResults{}, identifier++, textChunks);
+  for (size_t chunk = 0; chunk < textChunks; chunk++) {
+    auto *parse =
+        nodes.emplaceNode(ParseChunk{data._text, chunk}, identifier++);
+    parse->setDependencyAt(0, *split);
+    sum->setDependencyAt(chunk, *parse);
+  }
+
+  data._items = static_cast<std::int64_t>(textLines);
+  data._bytes = static_cast<std::int64_t>(data._text.size());
+  data._flopsPerByte = 0.0;
+}
+
+void buildWorkload(Workload workload, WorkloadData &data,
+                   dag::DynamicNodeList &nodes) {
+  switch (workload) {
+  case Workload::ImagePipeline:
+    buildImagePipeline(data, nodes);
+    break;
+  case Workload::ReductionTree:
+    buildReductionTree(data, nodes);
+    break;
+  case Workload::StringParsing:
+    buildStringParsing(data, nodes);
+    break;
+  }
+  nodes.sortNodes(dag::SortType::Depth);
+}
+
+void setWorkloadCounters(benchmark::State &state, const WorkloadData &data) {
+  state.SetItemsProcessed(state.iterations() * data._items);
+  state.SetBytesProcessed(state.iterations() * data._bytes);
+  state.counters["flops_per_byte"] = data._flopsPerByte;
+}
+
+// NOLINTNEXTLINE
+static void BM_SerialWorkload(benchmark::State &state) {
+  WorkloadData data{};
+  dag::DynamicNodeList nodes{workloadCapacity};
+  buildWorkload(static_cast<Workload>(state.range(0)), data, nodes);
+  std::atomic<bool> stopFlag{false};
+  core::SerialCoreRunner runner{};
+
+  for (auto _ : state) {
+    runner.runNodeListSerialOnce(nodes, stopFlag);
+  }
+
+  setWorkloadCounters(state, data);
+}
+BENCHMARK(BM_SerialWorkload)
+    ->ArgName("workload")
+    ->DenseRange(0, static_cast<std::int64_t>(Workload::StringParsing))
+    ->Unit(benchmark::kMicrosecond);
+
+template <size_t THREADS>
+// NOLINTNEXTLINE
+static void BM_ParallelWorkload(benchmark::State &state) {
+  WorkloadData data{};
+  dag::DynamicNodeList nodes{workloadCapacity};
+  buildWorkload(static_cast<Workload>(state.range(0)), data, nodes);
+  std::atomic<bool> stopFlag{false};
+  core::CoreThreadPool<THREADS, poolQueueSize, threadPool::NoInstrumentation>
+      tPool{};
+  core::ParallelCoreRunner runner{};
+
+  for (auto _ : state) {
+    runner.runNodeListParallelOnce(nodes, tPool, stopFlag);
+  }
+
+  setWorkloadCounters(state, data);
+}
+
+void workloadArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgName("workload")
+      ->DenseRange(0, static_cast<std::int64_t>(Workload::StringParsing))
+      ->Unit(benchmark::kMicrosecond)
+      ->UseRealTime();
+}
+
+BENCHMARK_TEMPLATE(BM_ParallelWorkload, 1)->Apply(workloadArguments);
+BENCHMARK_TEMPLATE(BM_ParallelWorkload, 2)->Apply(workloadArguments);
+BENCHMARK_TEMPLATE(BM_ParallelWorkload, 4)->Apply(workloadArguments);
+BENCHMARK_TEMPLATE(BM_ParallelWorkload, 8)->Apply(workloadArguments);
+
+} // namespace baltazar
+
+BENCHMARK_MAIN();
@@ -0,0 +1,195 @@
+#ifndef BALTAZAR_BINARY_TRACE_HPP
+#define BALTAZAR_BINARY_TRACE_HPP
+
+#include "../thread_pool/thread_task.hpp"
+#include "../utils/clock.hpp"
+#include "profiling.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+namespace baltazar {
+namespace core {
+
+// "BLTZ" when read as little endian bytes.
+constexpr std::uint32_t traceMagic = 0x5A544C42U;
+constexpr std::uint16_t traceVersion = 1U;
+
+enum class TraceRecordType : std::uint32_t { Job, Wave, Run, Custom };
+
+// Steady and system clocks are sampled back to back when trace is opened, so
+// reader can map steady timestamps to wall clock time.
+struct TraceFileHeader {
+  std::uint32_t _magic;
+  std::uint16_t _version;
+  std::uint16_t _recordSize;
+  std::int64_t _steadyOriginNs;
+  std::int64_t _systemOriginNs;
+  std::uint64_t _reserved[5];
+};
+
+// All timestamps are steady clock nanoseconds, TSC ticks are converted when
+// record is written. Job records fill t0..t3 with scheduled, started, ended and
+// synced time points and jobs run by the coordinator have _threadId
+// 0xFFFFFFFF. Wave, run and custom records only carry a duration, which is
+// stored as t0 = t1 - duration.
+struct TraceRecord {
+  std::uint32_t _type;
+  std::uint32_t _threadId;
+  std::uint64_t _identifier;
+  std::uint64_t _index;
+  std::uint64_t _wave;
+  std::int64_t _t0;
+  std::int64_t _t1;
+  std::int64_t _t2;
+  std::int64_t _t3;
+};
+
+static_assert(sizeof(TraceFileHeader) == 64, "Trace header layout changed.");
+static_assert(sizeof(TraceRecord) == 64, "Trace record layout changed.");
+
+inline std::int64_t toTraceNs(utils::ProfilingClock::time_point tp) {
+  return utils::ProfilingClock::toNanoseconds(tp);
+}
+
+// Buffers records and writes them in blocks. Stream has to be opened with
+// std::ios::binary.
+template <size_t BUFFER_RECORDS> class BinaryTraceWriter {
+public:
+  explicit BinaryTraceWriter(std::ofstream &s)
+      : m_out(s), m_buffer(std::make_unique<TraceRecord[]>(BUFFER_RECORDS)) {
+    TraceFileHeader header{};
+    header._magic = traceMagic;
+    header._version = traceVersion;
+    header._recordSize = sizeof(TraceRecord);
+    header._steadyOriginNs =
+        utils::SteadyClock::toNanoseconds(utils::SteadyClock::now());
+    header._systemOriginNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    m_out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  }
+
+  BinaryTraceWriter(const BinaryTraceWriter &other) = delete;
+  BinaryTraceWriter(BinaryTraceWriter &&other) = delete;
+
+  ~BinaryTraceWriter() { flush(); }
+
+  void append(const TraceRecord &record) {
+    std::memcpy(&m_buffer[m_size], &record, sizeof(TraceRecord));
+    m_size++;
+    if (m_size == BUFFER_RECORDS) {
+      flush();
+    }
+  }
+
+  void flush() {
+    if (m_size == 0) {
+      return;
+    }
+
+    m_out.write(reinterpret_cast<const char *>(m_buffer.get()),
+                static_cast<std::streamsize>(m_size * sizeof(TraceRecord)));
+    m_out.flush();
+    m_size = 0;
+  }
+
+private:
+  std::ofstream &m_out;
+  std::unique_ptr<TraceRecord[]> m_buffer;
+  size_t m_size{0};
+};
+
+// Single threaded profiler writing binary trace records. Jobs are tagged with
+// the wave they ran in, as announced by beginWave(), so waves skipped while
+// off or unsampled don't shift them.
+template <size_t BUFFER_RECORDS>
+class BinaryTraceCoreProfiler : public ICoreProfiler {
+public:
+  BinaryTraceCoreProfiler(std::ofstream &s, bool isOn)
+      : m_writer(s), m_on(isOn) {}
+
+  BinaryTraceCoreProfiler(const BinaryTraceCoreProfiler &other) = delete;
+  BinaryTraceCoreProfiler(BinaryTraceCoreProfiler &&other) = delete;
+
+  ~BinaryTraceCoreProfiler() {}
+
+  void logJob(threadPool::ThreadJob &job) override {
+    if (!isOn()) {
+      return;
+    }
+
+    TraceRecord record{};
+    record._type = static_cast<std::uint32_t>(TraceRecordType::Job);
+    record._threadId = static_cast<std::uint32_t>(job._threadId);
+    record._identifier = job._task->getIdentifier();
+    record._index = job._id;
+    record._wave = m_currentWave;
+    record._t0 = toTraceNs(job._scheduledTimePoint);
+    record._t1 = toTraceNs(job._startedTimePoint);
+    record._t2 = toTraceNs(job._endedTimePoint);
+    record._t3 = toTraceNs(job._syncedTimePoint);
+    m_writer.append(record);
+  }
+
+  bool beginWave(size_t waveNumber) override {
+    m_currentWave = waveNumber;
+    return isOn();
+  }
+
+  void logWave(microsecs waveTime, size_t waveNumber) override {
+    m_lastWave = waveNumber;
+    logDuration(TraceRecordType::Wave, 0UL, waveNumber, waveTime);
+  }
+
+  void logRun(microsecs runTime) override {
+    logDuration(TraceRecordType::Run, 0UL, 0UL, runTime);
+    m_writer.flush();
+  }
+
+  void logCustomDiff(microsecs totalTime, size_t customIdentifier) override {
+    logDuration(TraceRecordType::Custom, customIdentifier, 0UL, totalTime);
+  }
+
+  void turnOn() override { m_on.store(true, std::memory_order_relaxed); }
+
+  void turnOff() override { m_on.store(false, std::memory_order_relaxed); }
+
+  bool isOn() const override { return m_on.load(std::memory_order_relaxed); }
+
+  void flush() { m_writer.flush(); }
+
+private:
+  void logDuration(TraceRecordType type, size_t identifier, size_t index,
+                   microsecs duration) {
+    if (!isOn()) {
+      return;
+    }
+
+    TraceRecord record{};
+    record._type = static_cast<std::uint32_t>(type);
+    record._identifier = identifier;
+    record._index = index;
+    record._wave = m_lastWave;
+    record._t1 = toTraceNs(utils::ProfilingClock::now());
+    record._t0 = record._t1 -
+                 std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+                     .count();
+    m_writer.append(record);
+  }
+
+  BinaryTraceWriter<BUFFER_RECORDS> m_writer;
+  size_t m_currentWave{0};
+  size_t m_lastWave{0};
+  std::atomic<bool> m_on;
+};
+
+} // namespace core
+} // namespace baltazar
+
+#endif // BALTAZAR_BINARY_TRACE_HPP
@@ -3,33 +3,177 @@
 
 #include "../core/profiling.hpp"
 #include "../dag/dag.hpp"
+#include "../dag/dynamic_dag.hpp"
 #include "../thread_pool/thread_pool.hpp"
+#include "../utils/clock.hpp"
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <memory>
 #include <ostream>
 
 namespace baltazar {
 namespace core {
 
+template <size_t NUMBER_OF_THREADS, size_t TASK_BUFFER_SIZE,
+          typename INSTRUMENTATION>
+using CoreThreadPool =
+    threadPool::ThreadPool<NUMBER_OF_THREADS, TASK_BUFFER_SIZE,
+                           threadPool::BasicThreadJob<INSTRUMENTATION>,
+                           INSTRUMENTATION>;
+
+// With NullProfiler all profiling code is compiled out. Other profilers are
+// asked with beginWave() whether to time each wave and with isOn() whether to
+// time a run, so they can be switched while running. Jobs are only
+// timestamped when pool is instrumented.
 template <typename ProfilerType = NullProfiler> class ParallelCoreRunner {
 public:
+  static constexpr bool profilingEnabled =
+      !std::is_same_v<std::decay_t<ProfilerType>, NullProfiler>;
+
   ParallelCoreRunner(std::ofstream *s = nullptr, bool profilerOn = false)
       : m_profiler(*s, profilerOn) {
-    if constexpr (!std::is_same_v<std::decay_t<ProfilerType>, NullProfiler>) {
+    if constexpr (profilingEnabled) {
       assert(s != nullptr && "Profiler object provided is null.");
+      utils::ProfilingClock::calibrate();
     }
   }
 
   template <size_t NUM_OF_NODES, size_t NUMBER_OF_THREADS,
-            size_t TASK_BUFFER_SIZE>
+            size_t TASK_BUFFER_SIZE, typename INSTRUMENTATION>
   void runNodeListParallelOnce(
       dag::NodeList<NUM_OF_NODES> &nodes,
-      threadPool::ThreadPool<NUMBER_OF_THREADS, TASK_BUFFER_SIZE> &tPool,
+      CoreThreadPool<NUMBER_OF_THREADS, TASK_BUFFER_SIZE, INSTRUMENTATION>
+          &tPool,
       std::atomic<bool> &stopFlag, ICoreProfiler *profiler = nullptr) {
 
     std::array<bool, NUM_OF_NODES> doneFlags{};
     std::array<bool, NUM_OF_NODES> scheduledFlags{};
 
+    runWave(nodes, tPool, stopFlag, doneFlags.data(), scheduledFlags.data());
+  }
+
+  // Flags for runtime sized lists are kept between waves, so steady state
+  // waves don't allocate.
+  template <size_t NUMBER_OF_THREADS, size_t TASK_BUFFER_SIZE,
+            typename INSTRUMENTATION>
+  void runNodeListParallelOnce(
+      dag::DynamicNodeList &nodes,
+      CoreThreadPool<NUMBER_OF_THREADS, TASK_BUFFER_SIZE, INSTRUMENTATION>
+          &tPool,
+      std::atomic<bool> &stopFlag, ICoreProfiler *profiler = nullptr) {
+    size_t numberOfNodes = nodes.getNumberOfNodes();
+    if (m_flagsCapacity < numberOfNodes) {
+      m_flags = std::make_unique<bool[]>(2 * numberOfNodes);
+      m_flagsCapacity = numberOfNodes;
+    }
+    std::fill(m_flags.get(), m_flags.get() + 2 * numberOfNodes, false);
+
+    runWave(nodes, tPool, stopFlag, m_flags.get(),
+            m_flags.get() + numberOfNodes);
+  }
+
+  template <typename NODE_LIST, size_t NUMBER_OF_THREADS,
+            size_t TASK_BUFFER_SIZE, typename INSTRUMENTATION>
+  void runNodeListParallelNTimes(
+      NODE_LIST &nodes,
+      CoreThreadPool<NUMBER_OF_THREADS, TASK_BUFFER_SIZE, INSTRUMENTATION>
+          &tPool,
+      std::atomic<bool> &stopFlag, size_t n,
+      ICoreProfiler *profiler = nullptr) {
+    const bool profileRun = isProfiling();
+    utils::ProfilingClock::time_point startRunTimePoint{};
+    if (profileRun) {
+      startRunTimePoint = utils::ProfilingClock::now();
+    }
+
+    for (int iter = 0; iter < n; iter++) {
+      runNodeListParallelOnce(nodes, tPool, stopFlag);
+
+      if (stopFlag) {
+        break;
+      }
+    }
+
+    if (profileRun) {
+      m_profiler.logRun(utils::elapsed<microsecs>(
+          startRunTimePoint, utils::ProfilingClock::now()));
+    }
+  }
+
+  template <typename NODE_LIST, size_t NUMBER_OF_THREADS,
+            size_t TASK_BUFFER_SIZE, typename INSTRUMENTATION>
+  void runNodeListParallelLoop(
+      NODE_LIST &nodes,
+      CoreThreadPool<NUMBER_OF_THREADS, TASK_BUFFER_SIZE, INSTRUMENTATION>
+          &tPool,
+      std::atomic<bool> &stopFlag, ICoreProfiler *profiler = nullptr) {
+    const bool profileRun = isProfiling();
+    utils::ProfilingClock::time_point startRunTimePoint{};
+    if (profileRun) {
+      startRunTimePoint = utils::ProfilingClock::now();
+    }
+
+    while (!stopFlag) {
+      runNodeListParallelOnce(nodes, tPool, stopFlag);
+
+      if (stopFlag) {
+        break;
+      }
+    }
+
+    if (profileRun) {
+      m_profiler.logRun(utils::elapsed<microsecs>(
+          startRunTimePoint, utils::ProfilingClock::now()));
+    }
+  }
+
+  ProfilerType &getProfiler() { return m_profiler; }
+
+private:
+  bool isProfiling() const {
+    if constexpr (profilingEnabled) {
+      return m_profiler.isOn();
+    } else {
+      return false;
+    }
+  }
+
+  bool beginWave() {
+    if constexpr (profilingEnabled) {
+      return m_profiler.beginWave(m_waveNumber + 1);
+    } else {
+      return false;
+    }
+  }
+
+  template <typename INSTRUMENTATION>
+  static threadPool::BasicThreadJob<INSTRUMENTATION>
+  makeJob(dag::INode *node, size_t nodeIndex, bool profiled) {
+    threadPool::BasicThreadJob<INSTRUMENTATION> job{};
+    job._task = node;
+    job._id = nodeIndex;
+    job._shouldSyncWhenDone = true;
+    if constexpr (INSTRUMENTATION::enabled) {
+      job._profiled = profiled;
+    }
+    return job;
+  }
+
+  template <typename NODE_LIST, size_t NUMBER_OF_THREADS,
+            size_t TASK_BUFFER_SIZE, typename INSTRUMENTATION>
+  void runWave(
+      NODE_LIST &nodes,
+      CoreThreadPool<NUMBER_OF_THREADS, TASK_BUFFER_SIZE, INSTRUMENTATION>
+          &tPool,
+      std::atomic<bool> &stopFlag, bool *doneFlags, bool *scheduledFlags) {
+    const bool profileWave = beginWave();
+    const bool profileJobs = INSTRUMENTATION::enabled && profileWave;
+    utils::ProfilingClock::time_point startTimePoint{};
+    if (profileWave) {
+      startTimePoint = utils::ProfilingClock::now();
+    }
+
     for (size_t nodeIndex = 0; nodeIndex < nodes.getNumberOfNodes();
          nodeIndex++) {
       nodes.getNodeAt(nodeIndex)->reset();
@@ -42,7 +186,11 @@ public:
         dag::INode *node = nodes.getNodeAt(nodeIndex);
         if (node->isReady() && !doneFlags[nodeIndex] &&
             !scheduledFlags[nodeIndex]) {
-          tPool.scheduleTask({node, nodeIndex, true});
+          // Pool is full of unsynced tasks, collect done ones first.
+          if (!tPool.tryScheduleTask(makeJob<INSTRUMENTATION>(
+                  node, nodeIndex, profileJobs))) {
+            break;
+          }
           scheduledFlags[nodeIndex] = true;
         }
 
@@ -55,8 +203,7 @@ public:
         break;
       }
 
-      utils::Optional<threadPool::ThreadJob> doneJob =
-          tPool.tryGetNextDoneTask();
+      auto doneJob = tPool.tryGetNextDoneTask();
 
       while (doneJob.has_value()) {
         dag::INode *doneNode = static_cast<dag::INode *>(doneJob.value()._task);
@@ -64,93 +211,33 @@ public:
         doneFlags[doneJob.value()._id] = true;
         numberOfTasksDone++;
 
-#ifdef PROFILELOG
-        doneJob.value()._syncedTimePoint = std::chrono::steady_clock::now();
-
-        m_profiler.logJob(doneJob.value());
-#endif
+        if constexpr (INSTRUMENTATION::enabled) {
+          if (profileJobs) {
+            doneJob.value()._syncedTimePoint = utils::ProfilingClock::now();
+            m_profiler.logJob(doneJob.value());
+          }
+        }
 
         doneJob = tPool.tryGetNextDoneTask();
       }
     }
 
     m_waveNumber++;
-  }
-
-  template <size_t NUM_OF_NODES, size_t NUMBER_OF_THREADS,
-            size_t TASK_BUFFER_SIZE>
-  void runNodeListParallelNTimes(
-      dag::NodeList<NUM_OF_NODES> &nodes,
-      threadPool::ThreadPool<NUMBER_OF_THREADS, TASK_BUFFER_SIZE> &tPool,
-      std::atomic<bool> &stopFlag, size_t n,
-      ICoreProfiler *profiler = nullptr) {
-#ifdef PROFILELOG
-    auto startRunTimePoint = std::chrono::steady_clock::now();
-#endif
-    for (int iter = 0; iter < n; iter++) {
-#ifdef PROFILELOG
-      auto startTimePoint = std::chrono::steady_clock::now();
-#endif
-
-      runNodeListParallelOnce(nodes, tPool, stopFlag);
 
-#ifdef PROFILELOG
-      auto endTimePoint = std::chrono::steady_clock::now();
-
-      m_profiler.logWave(
-          std::chrono::duration_cast<microsecs>(endTimePoint - startTimePoint),
-          m_waveNumber);
-#endif
-
-      if (stopFlag) {
-        break;
-      }
+    if (profileWave) {
+      m_profiler.logWave(utils::elapsed<microsecs>(
+                             startTimePoint, utils::ProfilingClock::now()),
+                         m_waveNumber);
     }
-#ifdef PROFILELOG
-    auto endRunTimePoint = std::chrono::steady_clock::now();
-    m_profiler.logRun(std::chrono::duration_cast<microsecs>(endRunTimePoint -
-                                                            startRunTimePoint));
-#endif
-  }
-
-  template <size_t NUM_OF_NODES, size_t NUMBER_OF_THREADS,
-            size_t TASK_BUFFER_SIZE>
-  void runNodeListParallelLoop(
-      dag::NodeList<NUM_OF_NODES> &nodes,
-      threadPool::ThreadPool<NUMBER_OF_THREADS, TASK_BUFFER_SIZE> &tPool,
-      std::atomic<bool> &stopFlag, ICoreProfiler *profiler = nullptr) {
-#ifdef PROFILELOG
-    auto startRunTimePoint = std::chrono::steady_clock::now();
-#endif
-    while (!stopFlag) {
-#ifdef PROFILELOG
-      auto startTimePoint = std::chrono::steady_clock::now();
-#endif
-
-      runNodeListParallelOnce(nodes, tPool, stopFlag);
-
-#ifdef PROFILELOG
-      auto endTimePoint = std::chrono::steady_clock::now();
-
-      m_profiler.logWave(
-          std::chrono::duration_cast<microsecs>(endTimePoint - startTimePoint),
-          m_waveNumber);
-#endif
-
-      if (stopFlag) {
-        break;
-      }
+    if constexpr (profilingEnabled) {
+      m_profiler.endWave(m_waveNumber, numberOfTasksDone);
     }
-#ifdef PROFILELOG
-    auto endRunTimePoint = std::chrono::steady_clock::now();
-    m_profiler.logRun(std::chrono::duration_cast<microsecs>(endRunTimePoint -
-                                                            startRunTimePoint));
-#endif
   }
 
-private:
   size_t m_waveNumber{0};
   ProfilerType m_profiler;
+  std::unique_ptr<bool[]> m_flags;
+  size_t m_flagsCapacity{0};
 };
 
 ParallelCoreRunner()->ParallelCoreRunner<NullProfiler>;
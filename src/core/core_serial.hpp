@@ -3,6 +3,9 @@
 
 #include "../core/profiling.hpp"
 #include "../dag/dag.hpp"
+#include "../dag/dynamic_dag.hpp"
+#include "../dag/static_dag.hpp"
+#include "../utils/clock.hpp"
 #include <array>
 #include <atomic>
 #include <cassert>
@@ -13,110 +16,160 @@
 namespace baltazar {
 namespace core {
 
+// Profiling follows ParallelCoreRunner: compiled out with NullProfiler,
+// otherwise driven by beginWave() for waves and isOn() for runs.
 template <typename PROFILER_TYPE = NullProfiler> class SerialCoreRunner {
 public:
+  static constexpr bool profilingEnabled =
+      !std::is_same_v<std::decay_t<PROFILER_TYPE>, NullProfiler>;
+
   SerialCoreRunner(std::ofstream *s = nullptr, bool profilerOn = false)
       : m_profiler(*s, profilerOn) {
-    if constexpr (!std::is_same_v<std::decay_t<PROFILER_TYPE>, NullProfiler>) {
+    if constexpr (profilingEnabled) {
       assert(s != nullptr && "Profiler object provided is null.");
+      utils::ProfilingClock::calibrate();
     }
   }
 
-  template <size_t NUM_OF_NODES>
-  void runNodeListSerialOnce(dag::NodeList<NUM_OF_NODES> &nodes,
-                             std::atomic<bool> &stopFlag) {
+  // Accepts NodeList and DynamicNodeList.
+  template <typename NODE_LIST>
+  void runNodeListSerialOnce(NODE_LIST &nodes, std::atomic<bool> &stopFlag) {
+    const bool profileWave = beginWave();
+    utils::ProfilingClock::time_point startTimePoint{};
+    if (profileWave) {
+      startTimePoint = utils::ProfilingClock::now();
+    }
+
+    size_t numberOfNodesRun = 0;
     for (size_t nodeIndex = 0; nodeIndex < nodes.getNumberOfNodes();
          nodeIndex++) {
       dag::INode *currentNode = nodes.getNodeAt(nodeIndex);
 
-#ifdef PROFILELOG
-      threadPool::ThreadJob job{};
-      job._task = currentNode;
-      job._id = nodeIndex;
-      job._shouldSyncWhenDone = true;
-      job._scheduledTimePoint = std::chrono::steady_clock::now();
-      job._startedTimePoint = job._scheduledTimePoint;
-      job._threadId = 0;
-#endif
-
-      currentNode->run();
-      currentNode->setDone();
-
-#ifdef PROFILELOG
-      job._endedTimePoint = std::chrono::steady_clock::now();
-      job._syncedTimePoint = job._endedTimePoint;
-      m_profiler.logJob(job);
-#endif
+      if (profileWave) {
+        runProfiledNode(currentNode, nodeIndex);
+      } else {
+        currentNode->run();
+        currentNode->setDone();
+      }
+      numberOfNodesRun++;
 
       if (stopFlag) {
         break;
       }
     }
 
-    m_waveNumber++;
+    endWave(profileWave, startTimePoint, numberOfNodesRun);
   }
 
-  template <size_t NUM_OF_NODES>
-  void runNodeListSerialNTimes(dag::NodeList<NUM_OF_NODES> &nodes,
-                               std::atomic<bool> &stopFlag, size_t n) {
-#ifdef PROFILELOG
-    auto startRunTimePoint = std::chrono::steady_clock::now();
-#endif
-    for (int iter = 0; iter < n; iter++) {
-#ifdef PROFILELOG
-      auto startTimePoint = std::chrono::steady_clock::now();
-#endif
+  // Static graphs run as an inlined sequence of functor calls. Nodes are not
+  // thread tasks, so only waves and runs are profiled.
+  template <typename... NODES>
+  void runNodeListSerialOnce(dag::StaticGraph<NODES...> &graph,
+                             std::atomic<bool> &stopFlag) {
+    const bool profileWave = beginWave();
+    utils::ProfilingClock::time_point startTimePoint{};
+    if (profileWave) {
+      startTimePoint = utils::ProfilingClock::now();
+    }
 
-      runNodeListSerialOnce(nodes, stopFlag);
+    size_t numberOfNodesRun = graph.run(stopFlag);
 
-#ifdef PROFILELOG
-      auto endTimePoint = std::chrono::steady_clock::now();
+    endWave(profileWave, startTimePoint, numberOfNodesRun);
+  }
+
+  template <typename NODE_LIST>
+  void runNodeListSerialNTimes(NODE_LIST &nodes, std::atomic<bool> &stopFlag,
+                               size_t n) {
+    const bool profileRun = isProfiling();
+    utils::ProfilingClock::time_point startRunTimePoint{};
+    if (profileRun) {
+      startRunTimePoint = utils::ProfilingClock::now();
+    }
 
-      m_profiler.logWave(
-          std::chrono::duration_cast<microsecs>(endTimePoint - startTimePoint),
-          m_waveNumber);
-#endif
+    for (int iter = 0; iter < n; iter++) {
+      runNodeListSerialOnce(nodes, stopFlag);
 
       if (stopFlag) {
         break;
       }
     }
-#ifdef PROFILELOG
-    auto endRunTimePoint = std::chrono::steady_clock::now();
-    m_profiler.logRun(std::chrono::duration_cast<microsecs>(endRunTimePoint -
-                                                            startRunTimePoint));
-#endif
+
+    if (profileRun) {
+      m_profiler.logRun(utils::elapsed<microsecs>(
+          startRunTimePoint, utils::ProfilingClock::now()));
+    }
   }
 
-  template <size_t NUM_OF_NODES>
-  void runNodeListSerialLoop(dag::NodeList<NUM_OF_NODES> &nodes,
-                             std::atomic<bool> &stopFlag) {
-#ifdef PROFILELOG
-    auto startRunTimePoint = std::chrono::steady_clock::now();
-#endif
-    while (!stopFlag) {
-#ifdef PROFILELOG
-      auto startTimePoint = std::chrono::steady_clock::now();
-#endif
+  template <typename NODE_LIST>
+  void runNodeListSerialLoop(NODE_LIST &nodes, std::atomic<bool> &stopFlag) {
+    const bool profileRun = isProfiling();
+    utils::ProfilingClock::time_point startRunTimePoint{};
+    if (profileRun) {
+      startRunTimePoint = utils::ProfilingClock::now();
+    }
 
+    while (!stopFlag) {
       runNodeListSerialOnce(nodes, stopFlag);
+    }
 
-#ifdef PROFILELOG
-      auto endTimePoint = std::chrono::steady_clock::now();
-
-      m_profiler.logWave(
-          std::chrono::duration_cast<microsecs>(endTimePoint - startTimePoint),
-          m_waveNumber);
-#endif
+    if (profileRun) {
+      m_profiler.logRun(utils::elapsed<microsecs>(
+          startRunTimePoint, utils::ProfilingClock::now()));
     }
-#ifdef PROFILELOG
-    auto endRunTimePoint = std::chrono::steady_clock::now();
-    m_profiler.logRun(std::chrono::duration_cast<microsecs>(endRunTimePoint -
-                                                            startRunTimePoint));
-#endif
   }
 
+  PROFILER_TYPE &getProfiler() { return m_profiler; }
+
 private:
+  bool isProfiling() const {
+    if constexpr (profilingEnabled) {
+      return m_profiler.isOn();
+    } else {
+      return false;
+    }
+  }
+
+  void runProfiledNode(dag::INode *node, size_t nodeIndex) {
+    threadPool::ThreadJob job{};
+    job._task = node;
+    job._id = nodeIndex;
+    job._shouldSyncWhenDone = true;
+    job._profiled = true;
+    job._scheduledTimePoint = utils::ProfilingClock::now();
+    job._startedTimePoint = job._scheduledTimePoint;
+    job._threadId = threadPool::coordinatorThreadId;
+
+    node->run();
+    node->setDone();
+
+    job._endedTimePoint = utils::ProfilingClock::now();
+    job._syncedTimePoint = job._endedTimePoint;
+    m_profiler.logJob(job);
+  }
+
+  bool beginWave() {
+    if constexpr (profilingEnabled) {
+      return m_profiler.beginWave(m_waveNumber + 1);
+    } else {
+      return false;
+    }
+  }
+
+  void endWave(bool profileWave,
+               utils::ProfilingClock::time_point startTimePoint,
+               size_t numberOfNodesRun) {
+    m_waveNumber++;
+
+    if (profileWave) {
+      m_profiler.logWave(utils::elapsed<microsecs>(
+                             startTimePoint, utils::ProfilingClock::now()),
+                         m_waveNumber);
+    }
+    if constexpr (profilingEnabled) {
+      m_profiler.endWave(m_waveNumber, numberOfNodesRun);
+    }
+  }
+
   size_t m_waveNumber{0};
   PROFILER_TYPE m_profiler;
 };
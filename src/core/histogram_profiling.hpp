@@ -0,0 +1,174 @@
+#ifndef BALTAZAR_HISTOGRAM_PROFILING_HPP
+#define BALTAZAR_HISTOGRAM_PROFILING_HPP
+
+#include "../thread_pool/thread_task.hpp"
+#include "../utils/clock.hpp"
+#include "../utils/log_linear_histogram.hpp"
+#include "profiling.hpp"
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace baltazar {
+namespace core {
+
+enum class LatencyKind { Queue, Run, Sync };
+
+// All values are in nanoseconds.
+struct LatencyStats {
+  std::uint64_t _count;
+  std::uint64_t _p50;
+  std::uint64_t _p99;
+  std::uint64_t _p999;
+  std::uint64_t _max;
+};
+
+using LatencyHistogram = utils::LogLinearHistogram<5, 40>;
+
+inline LatencyStats computeLatencyStats(const LatencyHistogram &histogram) {
+  return {histogram.getCount(), histogram.valueAtPercentile(50.0),
+          histogram.valueAtPercentile(99.0),
+          histogram.valueAtPercentile(99.9), histogram.getMax()};
+}
+
+template <size_t MAX_IDENTIFIERS> struct LatencySnapshot {
+  struct TaskHistograms {
+    LatencyHistogram _queue;
+    LatencyHistogram _run;
+    LatencyHistogram _sync;
+  };
+
+  const LatencyHistogram &get(size_t identifier, LatencyKind kind) const {
+    const TaskHistograms &task = _tasks[identifier];
+    switch (kind) {
+    case LatencyKind::Queue:
+      return task._queue;
+    case LatencyKind::Run:
+      return task._run;
+    case LatencyKind::Sync:
+    default:
+      return task._sync;
+    }
+  }
+
+  void reset() {
+    for (TaskHistograms &task : _tasks) {
+      task._queue.reset();
+      task._run.reset();
+      task._sync.reset();
+    }
+    _wave.reset();
+    _droppedJobs = 0;
+  }
+
+  std::array<TaskHistograms, MAX_IDENTIFIERS> _tasks;
+  LatencyHistogram _wave;
+  // Jobs whose identifier is not below MAX_IDENTIFIERS.
+  size_t _droppedJobs{0};
+};
+
+// Aggregates queue, run and sync-wait times per task identifier into fixed
+// memory histograms instead of writing events out. Queries and
+// snapshotAndReset can be called from any thread; they share a mutex with the
+// logging side, which is only contended while a query is running.
+template <size_t MAX_IDENTIFIERS>
+class HistogramCoreProfiler : public ICoreProfiler {
+public:
+  using Snapshot = LatencySnapshot<MAX_IDENTIFIERS>;
+
+  HistogramCoreProfiler(std::ofstream & /*s*/, bool isOn)
+      : m_current(std::make_unique<Snapshot>()), m_on(isOn) {}
+
+  HistogramCoreProfiler(const HistogramCoreProfiler &other) = delete;
+  HistogramCoreProfiler(HistogramCoreProfiler &&other) = delete;
+
+  ~HistogramCoreProfiler() {}
+
+  void logJob(threadPool::ThreadJob &job) override {
+    if (!isOn()) {
+      return;
+    }
+
+    size_t identifier = job._task->getIdentifier();
+    std::lock_guard lock(m_mtx);
+    if (identifier >= MAX_IDENTIFIERS) {
+      m_current->_droppedJobs++;
+      return;
+    }
+
+    auto &task = m_current->_tasks[identifier];
+    task._queue.record(toNs(utils::ProfilingClock::elapsed(
+        job._scheduledTimePoint, job._startedTimePoint)));
+    task._run.record(toNs(utils::ProfilingClock::elapsed(
+        job._startedTimePoint, job._endedTimePoint)));
+    task._sync.record(toNs(utils::ProfilingClock::elapsed(
+        job._endedTimePoint, job._syncedTimePoint)));
+  }
+
+  void logWave(microsecs waveTime, size_t /*waveNumber*/) override {
+    if (!isOn()) {
+      return;
+    }
+
+    std::lock_guard lock(m_mtx);
+    m_current->_wave.record(toNs(waveTime));
+  }
+
+  void logRun(microsecs /*runTime*/) override {}
+
+  void logCustomDiff(microsecs /*totalTime*/,
+                     size_t /*customIdentifier*/) override {}
+
+  void turnOn() override { m_on.store(true, std::memory_order_relaxed); }
+
+  void turnOff() override { m_on.store(false, std::memory_order_relaxed); }
+
+  bool isOn() const override { return m_on.load(std::memory_order_relaxed); }
+
+  LatencyStats getStats(size_t identifier, LatencyKind kind) const {
+    assert(identifier < MAX_IDENTIFIERS && "Index out of bounds!");
+    std::lock_guard lock(m_mtx);
+    return computeLatencyStats(m_current->get(identifier, kind));
+  }
+
+  LatencyStats getWaveStats() const {
+    std::lock_guard lock(m_mtx);
+    return computeLatencyStats(m_current->_wave);
+  }
+
+  // Swaps collected histograms with the spare one, so the lock is only held
+  // for a pointer swap. Spare is allocated on first use and cleared outside
+  // the lock; it holds the finished interval afterwards.
+  void snapshotAndReset(std::unique_ptr<Snapshot> &spare) {
+    if (spare == nullptr) {
+      spare = std::make_unique<Snapshot>();
+    } else {
+      spare->reset();
+    }
+
+    std::lock_guard lock(m_mtx);
+    m_current.swap(spare);
+  }
+
+private:
+  template <typename DURATION> static std::uint64_t toNs(DURATION duration) {
+    auto ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    return ns < 0 ? 0U : static_cast<std::uint64_t>(ns);
+  }
+
+  mutable std::mutex m_mtx;
+  std::unique_ptr<Snapshot> m_current;
+  std::atomic<bool> m_on;
+};
+
+} // namespace core
+} // namespace baltazar
+
+#endif // BALTAZAR_HISTOGRAM_PROFILING_HPP
@@ -0,0 +1,220 @@
+#ifndef BALTAZAR_LOCK_FREE_PROFILING_HPP
+#define BALTAZAR_LOCK_FREE_PROFILING_HPP
+
+#include "../thread_pool/thread_task.hpp"
+#include "../utils/spsc_ring.hpp"
+#include "profiling.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+namespace baltazar {
+namespace core {
+
+enum class ProfilingEventType : unsigned char { Job, Wave, Run, Custom };
+
+struct ProfilingEvent {
+  ProfilingEventType _type;
+  threadPool::ThreadJob _job;
+  size_t _number;
+  microsecs _duration;
+};
+
+// Every producer thread claims its own wait-free SPSC ring on first use and
+// logging thread drains all rings in batches. When a ring is full, or all
+// MAX_PRODUCERS rings are claimed, event is counted as dropped instead of
+// blocking the caller. Ring is released when its thread exits or starts
+// logging to another profiler. Events from different rings may be
+// interleaved in output.
+template <size_t RING_SIZE, size_t MAX_PRODUCERS = 4>
+class LockFreeCoreProfiler : public ICoreProfiler {
+public:
+  static constexpr size_t batchSize = 256UL;
+  static constexpr std::chrono::microseconds pollInterval{500};
+
+  LockFreeCoreProfiler(std::ofstream &s, bool isOn)
+      : m_out(s), m_rings(new Ring[MAX_PRODUCERS]),
+        m_instanceId(nextInstanceId()), m_on(isOn),
+        m_loggingThread(
+            &LockFreeCoreProfiler<RING_SIZE, MAX_PRODUCERS>::processRings,
+            this) {}
+
+  LockFreeCoreProfiler(const LockFreeCoreProfiler &other) = delete;
+  LockFreeCoreProfiler(LockFreeCoreProfiler &&other) = delete;
+
+  ~LockFreeCoreProfiler() {
+    this->shutdown();
+
+    if (m_loggingThread.joinable()) {
+      m_loggingThread.join();
+    }
+  }
+
+  void shutdown() { m_stop.store(true, std::memory_order_release); }
+
+  void logJob(threadPool::ThreadJob &job) override {
+    push({ProfilingEventType::Job, job, 0UL, microsecs{0}});
+  }
+
+  void logWave(microsecs waveTime, size_t waveNumber) override {
+    push({ProfilingEventType::Wave, {}, waveNumber, waveTime});
+  }
+
+  void logRun(microsecs runTime) override {
+    push({ProfilingEventType::Run, {}, 0UL, runTime});
+  }
+
+  void logCustomDiff(microsecs totalTime, size_t customIdentifier) override {
+    push({ProfilingEventType::Custom, {}, customIdentifier, totalTime});
+  }
+
+  void turnOn() override { m_on.store(true, std::memory_order_relaxed); }
+
+  void turnOff() override { m_on.store(false, std::memory_order_relaxed); }
+
+  bool isOn() const override { return m_on.load(std::memory_order_relaxed); }
+
+  size_t getDroppedEvents() const {
+    size_t dropped = m_unclaimedDrops.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < MAX_PRODUCERS; i++) {
+      dropped += m_rings[i]._drops.load(std::memory_order_relaxed);
+    }
+    return dropped;
+  }
+
+private:
+  struct Ring {
+    std::atomic<std::thread::id> _owner{};
+    std::atomic<size_t> _drops{0UL};
+    utils::SpscRing<ProfilingEvent, RING_SIZE> _events;
+  };
+
+  // Thread's claim on a ring. Shares ownership of the rings, so a thread
+  // exiting after the profiler still releases valid memory.
+  struct RingLease {
+    size_t _instanceId{0UL};
+    std::shared_ptr<Ring[]> _rings;
+    Ring *_ring{nullptr};
+
+    RingLease() = default;
+    RingLease(const RingLease &other) = delete;
+    RingLease &operator=(const RingLease &other) = delete;
+    ~RingLease() { release(); }
+
+    void release() {
+      if (_ring != nullptr) {
+        _ring->_owner.store(std::thread::id{}, std::memory_order_release);
+      }
+      _instanceId = 0UL;
+      _rings.reset();
+      _ring = nullptr;
+    }
+  };
+
+  static size_t nextInstanceId() {
+    static std::atomic<size_t> instanceCounter{1UL};
+    return instanceCounter.fetch_add(1UL, std::memory_order_relaxed);
+  }
+
+  void push(const ProfilingEvent &event) {
+    if (!isOn()) {
+      return;
+    }
+
+    Ring *ring = getProducerRing();
+    if (ring == nullptr) {
+      m_unclaimedDrops.fetch_add(1UL, std::memory_order_relaxed);
+      return;
+    }
+
+    if (!ring->_events.tryPush(event)) {
+      // Only owner thread writes its drop counter.
+      ring->_drops.store(ring->_drops.load(std::memory_order_relaxed) + 1UL,
+                         std::memory_order_relaxed);
+    }
+  }
+
+  // Cached per thread, keyed by instance id so a new profiler at the same
+  // address doesn't reuse a stale ring.
+  Ring *getProducerRing() {
+    thread_local RingLease lease{};
+
+    if (lease._instanceId == m_instanceId) {
+      return lease._ring;
+    }
+    lease.release();
+
+    const std::thread::id self = std::this_thread::get_id();
+    Ring *ring = nullptr;
+    for (size_t i = 0; i < MAX_PRODUCERS && ring == nullptr; i++) {
+      std::thread::id unclaimed{};
+      if (m_rings[i]._owner.compare_exchange_strong(
+              unclaimed, self, std::memory_order_acq_rel)) {
+        ring = &m_rings[i];
+      }
+    }
+
+    if (ring != nullptr) {
+      lease._instanceId = m_instanceId;
+      lease._rings = m_rings;
+      lease._ring = ring;
+    }
+    return ring;
+  }
+
+  size_t drainRings() {
+    size_t drained = 0;
+    for (size_t i = 0; i < MAX_PRODUCERS; i++) {
+      drained += m_rings[i]._events.consume(
+          [this](ProfilingEvent &event) { writeEvent(event); }, batchSize);
+    }
+    return drained;
+  }
+
+  void writeEvent(ProfilingEvent &event) {
+    switch (event._type) {
+    case ProfilingEventType::Job:
+      logJobFunction(m_out, event._job);
+      break;
+    case ProfilingEventType::Wave:
+      logWaveFunction(m_out, event._number, event._duration);
+      break;
+    case ProfilingEventType::Run:
+      logRunFunction(m_out, event._duration);
+      break;
+    case ProfilingEventType::Custom:
+      logCustomDurationFunction(m_out, event._number, event._duration);
+      break;
+    }
+  }
+
+  void processRings() {
+    while (!m_stop.load(std::memory_order_acquire)) {
+      if (drainRings() == 0UL) {
+        m_out.flush();
+        std::this_thread::sleep_for(pollInterval);
+      }
+    }
+
+    while (drainRings() > 0UL) {
+    }
+    m_out.flush();
+  }
+
+  std::ofstream &m_out;
+  std::shared_ptr<Ring[]> m_rings;
+  std::atomic<size_t> m_unclaimedDrops{0UL};
+  size_t m_instanceId;
+  std::atomic<bool> m_on;
+  std::atomic<bool> m_stop{false};
+  std::thread m_loggingThread;
+};
+
+} // namespace core
+} // namespace baltazar
+
+#endif // BALTAZAR_LOCK_FREE_PROFILING_HPP
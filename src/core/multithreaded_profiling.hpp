@@ -18,10 +18,9 @@ template <size_t QUEUE_SIZE>
 class MultiThreadedCoreProfiler : public ICoreProfiler {
 public:
   MultiThreadedCoreProfiler(std::ofstream &s, bool isOn)
-      : m_out(s),
+      : m_out(s), m_on(isOn),
         m_loggingThread(&MultiThreadedCoreProfiler<QUEUE_SIZE>::processQueue,
-                        this),
-        m_on(isOn) {}
+                        this) {}
 
   MultiThreadedCoreProfiler(const MultiThreadedCoreProfiler &other) = delete;
   MultiThreadedCoreProfiler(MultiThreadedCoreProfiler &&other) = default;
@@ -43,6 +42,10 @@ public:
   }
 
   void logJob(threadPool::ThreadJob &job) override {
+    if (!isOn()) {
+      return;
+    }
+
     std::unique_lock lock(m_mtx);
 
     m_popedTaskCv.wait(lock, [this] { return !m_tasksToLog.full() || m_stop; });
@@ -59,20 +62,37 @@ public:
   }
 
   void logWave(microsecs waveTime, size_t waveNumber) override {
+    if (!isOn()) {
+      return;
+    }
+
     std::lock_guard lg{m_mtx};
     logWaveFunction(m_out, waveNumber, waveTime);
   }
 
-  void logRun(microsecs runTime) override { logRunFunction(m_out, runTime); }
+  void logRun(microsecs runTime) override {
+    if (!isOn()) {
+      return;
+    }
+
+    std::lock_guard lg{m_mtx};
+    logRunFunction(m_out, runTime);
+  }
 
   void logCustomDiff(microsecs totalTime, size_t customIdentifier) override {
+    if (!isOn()) {
+      return;
+    }
+
     std::lock_guard lg{m_mtx};
     logCustomDurationFunction(m_out, customIdentifier, totalTime);
   }
 
-  void turnOn() override { m_on = true; }
+  void turnOn() override { m_on.store(true, std::memory_order_relaxed); }
+
+  void turnOff() override { m_on.store(false, std::memory_order_relaxed); }
 
-  void turnOff() override { m_on = false; }
+  bool isOn() const override { return m_on.load(std::memory_order_relaxed); }
 
 private:
   void processQueue() {
@@ -93,13 +113,14 @@ private:
   }
 
   std::ofstream &m_out;
-  std::thread m_loggingThread;
   threadPool::TaskQueue<QUEUE_SIZE> m_tasksToLog;
   std::mutex m_mtx;
   std::condition_variable m_addTaskCv;
   std::condition_variable m_popedTaskCv;
   bool m_stop{false};
   std::atomic<bool> m_on;
+  // Started last, after everything processQueue uses is constructed.
+  std::thread m_loggingThread;
 };
 
 } // namespace core
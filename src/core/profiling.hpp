@@ -2,6 +2,8 @@
 #define BALTAZAR_PROFILING_HPP
 
 #include "../thread_pool/thread_task.hpp"
+#include "../utils/clock.hpp"
+#include <atomic>
 #include <cstddef>
 #include <fstream>
 
@@ -11,18 +13,16 @@ namespace core {
 using microsecs = std::chrono::microseconds;
 
 inline void logJobFunction(std::ofstream &ofs, threadPool::ThreadJob &job) {
-#ifdef PROFILELOG
-  auto scheduledTime = std::chrono::duration_cast<microsecs>(
-      job._startedTimePoint - job._scheduledTimePoint);
-  auto runningTime = std::chrono::duration_cast<microsecs>(
-      job._endedTimePoint - job._startedTimePoint);
-  auto waitingTime = std::chrono::duration_cast<microsecs>(
-      job._syncedTimePoint - job._endedTimePoint);
+  auto scheduledTime = utils::elapsed<microsecs>(job._scheduledTimePoint,
+                                                 job._startedTimePoint);
+  auto runningTime =
+      utils::elapsed<microsecs>(job._startedTimePoint, job._endedTimePoint);
+  auto waitingTime =
+      utils::elapsed<microsecs>(job._endedTimePoint, job._syncedTimePoint);
 
   ofs << "J, " << job._task->getIdentifier() << ", " << job._id << ", "
       << job._threadId << ", " << scheduledTime.count() << ", "
       << runningTime.count() << ", " << waitingTime.count() << "\n";
-#endif
 }
 
 inline void logWaveFunction(std::ofstream &ofs, size_t waveNumber,
@@ -49,6 +49,16 @@ public:
   virtual void logCustomDiff(microsecs totalTime, size_t customIdentifier) = 0;
   virtual void turnOn() = 0;
   virtual void turnOff() = 0;
+  // Runners check this once per run and skip timestamping when it's off, so
+  // it can be flipped from any thread while running.
+  virtual bool isOn() const = 0;
+
+  // Called by runners before every wave. Returning false skips timestamping
+  // and logging of the wave and its jobs.
+  virtual bool beginWave(size_t /*waveNumber*/) { return isOn(); }
+
+  // Called by runners after every wave, whether it was timestamped or not.
+  virtual void endWave(size_t /*waveNumber*/, size_t /*numberOfJobs*/) {}
 };
 
 template <size_t QUEUE_SIZE>
@@ -57,13 +67,13 @@ public:
   SingleThreadedCoreProfiler(std::ofstream &s, bool isOn)
       : m_out(s), m_on(isOn) {}
 
-  SingleThreadedCoreProfiler(const SingleThreadedCoreProfiler &other) = default;
-  SingleThreadedCoreProfiler(SingleThreadedCoreProfiler &&other) = default;
+  SingleThreadedCoreProfiler(const SingleThreadedCoreProfiler &other) = delete;
+  SingleThreadedCoreProfiler(SingleThreadedCoreProfiler &&other) = delete;
 
   ~SingleThreadedCoreProfiler() {}
 
   void logJob(threadPool::ThreadJob &job) override {
-    if (!m_on) {
+    if (!isOn()) {
       return;
     }
 
@@ -77,23 +87,33 @@ public:
   }
 
   void logWave(microsecs waveTime, size_t waveNumber) override {
-    logWaveFunction(m_out, waveNumber, waveTime);
+    if (isOn()) {
+      logWaveFunction(m_out, waveNumber, waveTime);
+    }
   }
 
-  void logRun(microsecs runTime) override { logRunFunction(m_out, runTime); }
+  void logRun(microsecs runTime) override {
+    if (isOn()) {
+      logRunFunction(m_out, runTime);
+    }
+  }
 
   void logCustomDiff(microsecs totalTime, size_t customIdentifier) override {
-    logCustomDurationFunction(m_out, customIdentifier, totalTime);
+    if (isOn()) {
+      logCustomDurationFunction(m_out, customIdentifier, totalTime);
+    }
   }
 
-  void turnOn() override { m_on = true; }
+  void turnOn() override { m_on.store(true, std::memory_order_relaxed); }
 
-  void turnOff() override { m_on = false; }
+  void turnOff() override { m_on.store(false, std::memory_order_relaxed); }
+
+  bool isOn() const override { return m_on.load(std::memory_order_relaxed); }
 
 private:
   std::ofstream &m_out;
   size_t m_counter{0};
-  bool m_on;
+  std::atomic<bool> m_on;
 };
 
 class NullProfiler : public ICoreProfiler {
@@ -116,6 +136,8 @@ public:
 
   void turnOff() override {}
 
+  bool isOn() const override { return false; }
+
 private:
 };
 
@@ -0,0 +1,163 @@
+#ifndef BALTAZAR_SAMPLED_PROFILING_HPP
+#define BALTAZAR_SAMPLED_PROFILING_HPP
+
+#include "../thread_pool/thread_task.hpp"
+#include "../utils/clock.hpp"
+#include "profiling.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <fstream>
+
+namespace baltazar {
+namespace core {
+
+struct SamplingConfig {
+  // Every n-th wave is logged, 1 logs all of them.
+  size_t _waveInterval{1};
+  // Share of jobs from logged waves that are forwarded.
+  double _jobFraction{1.0};
+  // Jobs running at least this long are forwarded from any wave. Zero turns
+  // it off; otherwise every wave is timestamped to find them.
+  microsecs _slowJobThreshold{0};
+};
+
+// Exact totals, counted whether events were forwarded or not.
+struct SamplingCounters {
+  std::uint64_t _waves;
+  std::uint64_t _jobs;
+  std::uint64_t _sampledWaves;
+  std::uint64_t _sampledJobs;
+  std::uint64_t _slowJobs;
+};
+
+// Forwards a sample of waves and jobs to the INNER profiler. Runs and custom
+// diffs are always forwarded. Job sampling draws from a xorshift generator,
+// so logJob should be called from a single thread, which is what runners do.
+template <typename INNER> class SampledCoreProfiler : public ICoreProfiler {
+public:
+  SampledCoreProfiler(std::ofstream &s, bool isOn)
+      : m_inner(s, isOn), m_on(isOn) {}
+
+  SampledCoreProfiler(const SampledCoreProfiler &other) = delete;
+  SampledCoreProfiler(SampledCoreProfiler &&other) = delete;
+
+  ~SampledCoreProfiler() {}
+
+  // Should be set before running, it is not synchronized with runners.
+  void setSamplingConfig(const SamplingConfig &config) {
+    assert(config._waveInterval > 0 && "Wave interval must be positive!");
+    m_config = config;
+    m_jobThreshold = static_cast<std::uint64_t>(
+        config._jobFraction * static_cast<double>(UINT64_MAX));
+    if (config._jobFraction >= 1.0) {
+      m_jobThreshold = UINT64_MAX;
+    }
+  }
+
+  const SamplingConfig &getSamplingConfig() const { return m_config; }
+
+  // Inner profiler hears about every wave, so it can tag forwarded jobs.
+  bool beginWave(size_t waveNumber) override {
+    m_inner.beginWave(waveNumber);
+    if (!isOn()) {
+      return false;
+    }
+
+    m_waveSampled = m_waveCounter++ % m_config._waveInterval == 0;
+    return m_waveSampled || m_config._slowJobThreshold.count() > 0;
+  }
+
+  void endWave(size_t waveNumber, size_t numberOfJobs) override {
+    m_waves.fetch_add(1, std::memory_order_relaxed);
+    m_jobs.fetch_add(numberOfJobs, std::memory_order_relaxed);
+    m_inner.endWave(waveNumber, numberOfJobs);
+  }
+
+  void logJob(threadPool::ThreadJob &job) override {
+    if (!isOn()) {
+      return;
+    }
+
+    if (isSlow(job)) {
+      m_slowJobs.fetch_add(1, std::memory_order_relaxed);
+      m_sampledJobs.fetch_add(1, std::memory_order_relaxed);
+      m_inner.logJob(job);
+    } else if (m_waveSampled && nextRandom() <= m_jobThreshold) {
+      m_sampledJobs.fetch_add(1, std::memory_order_relaxed);
+      m_inner.logJob(job);
+    }
+  }
+
+  void logWave(microsecs waveTime, size_t waveNumber) override {
+    if (!isOn() || !m_waveSampled) {
+      return;
+    }
+
+    m_sampledWaves.fetch_add(1, std::memory_order_relaxed);
+    m_inner.logWave(waveTime, waveNumber);
+  }
+
+  void logRun(microsecs runTime) override { m_inner.logRun(runTime); }
+
+  void logCustomDiff(microsecs totalTime, size_t customIdentifier) override {
+    m_inner.logCustomDiff(totalTime, customIdentifier);
+  }
+
+  void turnOn() override {
+    m_on.store(true, std::memory_order_relaxed);
+    m_inner.turnOn();
+  }
+
+  void turnOff() override {
+    m_on.store(false, std::memory_order_relaxed);
+    m_inner.turnOff();
+  }
+
+  bool isOn() const override { return m_on.load(std::memory_order_relaxed); }
+
+  SamplingCounters getCounters() const {
+    return {m_waves.load(std::memory_order_relaxed),
+            m_jobs.load(std::memory_order_relaxed),
+            m_sampledWaves.load(std::memory_order_relaxed),
+            m_sampledJobs.load(std::memory_order_relaxed),
+            m_slowJobs.load(std::memory_order_relaxed)};
+  }
+
+  INNER &getInner() { return m_inner; }
+
+private:
+  bool isSlow(const threadPool::ThreadJob &job) const {
+    return m_config._slowJobThreshold.count() > 0 &&
+           utils::elapsed<microsecs>(job._startedTimePoint,
+                                     job._endedTimePoint) >=
+               m_config._slowJobThreshold;
+  }
+
+  std::uint64_t nextRandom() {
+    m_randomState ^= m_randomState << 13U;
+    m_randomState ^= m_randomState >> 7U;
+    m_randomState ^= m_randomState << 17U;
+    return m_randomState;
+  }
+
+  INNER m_inner;
+  std::atomic<bool> m_on;
+  SamplingConfig m_config{};
+  std::uint64_t m_jobThreshold{UINT64_MAX};
+  std::uint64_t m_randomState{0x9E3779B97F4A7C15ULL};
+  size_t m_waveCounter{0};
+  bool m_waveSampled{false};
+
+  std::atomic<std::uint64_t> m_waves{0};
+  std::atomic<std::uint64_t> m_jobs{0};
+  std::atomic<std::uint64_t> m_sampledWaves{0};
+  std::atomic<std::uint64_t> m_sampledJobs{0};
+  std::atomic<std::uint64_t> m_slowJobs{0};
+};
+
+} // namespace core
+} // namespace baltazar
+
+#endif // BALTAZAR_SAMPLED_PROFILING_HPP
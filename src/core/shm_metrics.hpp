@@ -0,0 +1,290 @@
+#ifndef BALTAZAR_SHM_METRICS_HPP
+#define BALTAZAR_SHM_METRICS_HPP
+
+#include "../thread_pool/pool_metrics.hpp"
+#include "../utils/clock.hpp"
+#include "histogram_profiling.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace baltazar {
+namespace core {
+
+// "BLTM" when read as little endian bytes.
+constexpr std::uint32_t shmMetricsMagic = 0x4D544C42U;
+constexpr std::uint32_t shmMetricsVersion = 2U;
+constexpr size_t shmMaxNodes = 64;
+constexpr size_t shmMaxWorkers = 64;
+
+// Latencies are in nanoseconds.
+struct ShmLatency {
+  std::uint64_t _count;
+  std::uint64_t _p50Ns;
+  std::uint64_t _p99Ns;
+  std::uint64_t _maxNs;
+};
+
+struct ShmWorker {
+  std::uint64_t _tasks;
+  // Share of the interval the worker was not waiting for a job, 0 unless
+  // ShmMetrics::_hasUtilization is set.
+  double _utilization;
+};
+
+// Everything except _publishCount and _maxQueueDepth covers the interval
+// since the previous publish.
+struct ShmMetrics {
+  std::int64_t _publishedNs;
+  std::uint64_t _intervalNs;
+  std::uint64_t _publishCount;
+  double _waveRate;
+  ShmLatency _wave;
+  double _meanQueueDepth;
+  std::uint64_t _maxQueueDepth;
+  std::uint64_t _rejections;
+  std::uint32_t _numberOfNodes;
+  std::uint32_t _numberOfWorkers;
+  // Idle time is only counted while pool metrics are on, so utilization is
+  // only known for intervals they were on at both ends of.
+  std::uint32_t _hasUtilization;
+  ShmWorker _workers[shmMaxWorkers];
+  // Run time per task identifier.
+  ShmLatency _nodes[shmMaxNodes];
+};
+
+// Metrics are guarded by a seqlock: writer makes _sequence odd while it
+// copies, readers retry until they see the same even value before and after
+// their copy.
+struct ShmMetricsSegment {
+  std::uint32_t _magic;
+  std::uint32_t _version;
+  std::atomic<std::uint64_t> _sequence;
+  ShmMetrics _metrics;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "Seqlock sequence has to be lock free to be shared.");
+
+inline ShmLatency toShmLatency(const LatencyHistogram &histogram) {
+  LatencyStats stats = computeLatencyStats(histogram);
+  return {stats._count, stats._p50, stats._p99, stats._max};
+}
+
+// Publishes rolling metrics into a POSIX shared memory segment, which is
+// created on construction and unlinked on destruction. Publishing is meant to
+// run on a monitoring thread, fed by HistogramCoreProfiler::snapshotAndReset
+// and ThreadPool::getMetrics, so runners and workers never wait on it. If the
+// segment can't be created, isOpen() is false and publish does nothing.
+class SharedMemoryMetricsExporter {
+public:
+  // POSIX names start with a slash, e.g. "/baltazar_metrics".
+  explicit SharedMemoryMetricsExporter(const std::string &name)
+      : m_name(name), m_lastPublish(utils::SteadyClock::now()) {
+    assert(!name.empty() && name[0] == '/' && "Name must start with '/'.");
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+      return;
+    }
+
+    if (ftruncate(fd, sizeof(ShmMetricsSegment)) == 0) {
+      void *memory = mmap(nullptr, sizeof(ShmMetricsSegment),
+                          PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (memory != MAP_FAILED) {
+        m_segment = new (memory) ShmMetricsSegment{};
+        m_segment->_version = shmMetricsVersion;
+        std::atomic_thread_fence(std::memory_order_release);
+        m_segment->_magic = shmMetricsMagic;
+      }
+    }
+    close(fd);
+
+    if (m_segment == nullptr) {
+      shm_unlink(name.c_str());
+    }
+  }
+
+  SharedMemoryMetricsExporter(const SharedMemoryMetricsExporter &other) =
+      delete;
+  SharedMemoryMetricsExporter(SharedMemoryMetricsExporter &&other) = delete;
+
+  ~SharedMemoryMetricsExporter() {
+    if (m_segment != nullptr) {
+      munmap(m_segment, sizeof(ShmMetricsSegment));
+      shm_unlink(m_name.c_str());
+    }
+  }
+
+  bool isOpen() const { return m_segment != nullptr; }
+
+  // Interval is the snapshot swapped out by snapshotAndReset. Pool metrics
+  // are cumulative, differences to the previous call are published. Worker
+  // utilization needs pool metrics on for this and the previous call, so the
+  // first publish never has it.
+  template <size_t MAX_IDENTIFIERS, size_t THREAD_NUM>
+  void publish(const LatencySnapshot<MAX_IDENTIFIERS> &interval,
+               const threadPool::PoolMetrics<THREAD_NUM> &pool) {
+    static_assert(THREAD_NUM <= shmMaxWorkers, "Too many workers to export.");
+    if (m_segment == nullptr) {
+      return;
+    }
+
+    auto now = utils::SteadyClock::now();
+    auto intervalNs = static_cast<std::uint64_t>(
+        utils::SteadyClock::elapsed(m_lastPublish, now).count());
+    m_lastPublish = now;
+
+    ShmMetrics &metrics = m_staging;
+    metrics._publishedNs = utils::SteadyClock::toNanoseconds(now);
+    metrics._intervalNs = intervalNs;
+    metrics._publishCount++;
+    metrics._wave = toShmLatency(interval._wave);
+    metrics._waveRate = intervalNs == 0
+                            ? 0.0
+                            : static_cast<double>(metrics._wave._count) *
+                                  1e9 / static_cast<double>(intervalNs);
+
+    constexpr size_t numberOfNodes = std::min(MAX_IDENTIFIERS, shmMaxNodes);
+    metrics._numberOfNodes = static_cast<std::uint32_t>(numberOfNodes);
+    for (size_t i = 0; i < numberOfNodes; i++) {
+      metrics._nodes[i] = toShmLatency(interval._tasks[i]._run);
+    }
+
+    std::uint64_t samples =
+        pool._queueDepthSamples - m_previousPool._queueDepthSamples;
+    std::uint64_t depthSum =
+        pool._queueDepthSum - m_previousPool._queueDepthSum;
+    metrics._meanQueueDepth =
+        samples == 0 ? 0.0
+                     : static_cast<double>(depthSum) /
+                           static_cast<double>(samples);
+    metrics._maxQueueDepth = pool._maxQueueDepth;
+    metrics._rejections = pool._rejections - m_previousPool._rejections;
+
+    std::uint64_t uptimeNs = pool._uptimeNs - m_previousPool._uptimeNs;
+    const bool hasUtilization =
+        pool._collected && m_previousPool._collected && uptimeNs > 0;
+    metrics._hasUtilization = hasUtilization ? 1U : 0U;
+    metrics._numberOfWorkers = static_cast<std::uint32_t>(THREAD_NUM);
+    for (size_t i = 0; i < THREAD_NUM; i++) {
+      const threadPool::WorkerMetrics &worker = pool._workers[i];
+      const threadPool::WorkerMetrics &previous = m_previousPool._workers[i];
+      double utilization = 0.0;
+      if (hasUtilization) {
+        double idle = static_cast<double>(worker._idleNs - previous._idleNs) /
+                      static_cast<double>(uptimeNs);
+        utilization = 1.0 - std::clamp(idle, 0.0, 1.0);
+      }
+      metrics._workers[i] = {worker._tasks - previous._tasks, utilization};
+    }
+
+    m_previousPool._queueDepthSamples = pool._queueDepthSamples;
+    m_previousPool._queueDepthSum = pool._queueDepthSum;
+    m_previousPool._rejections = pool._rejections;
+    m_previousPool._uptimeNs = pool._uptimeNs;
+    m_previousPool._collected = pool._collected;
+    std::copy(pool._workers.begin(), pool._workers.end(),
+              m_previousPool._workers.begin());
+
+    write(metrics);
+  }
+
+private:
+  void write(const ShmMetrics &metrics) {
+    std::uint64_t sequence =
+        m_segment->_sequence.load(std::memory_order_relaxed);
+    m_segment->_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&m_segment->_metrics, &metrics, sizeof(ShmMetrics));
+    m_segment->_sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  std::string m_name;
+  ShmMetricsSegment *m_segment{nullptr};
+  ShmMetrics m_staging{};
+  threadPool::PoolMetrics<shmMaxWorkers> m_previousPool{};
+  utils::SteadyClock::time_point m_lastPublish;
+};
+
+// Maps a segment created by SharedMemoryMetricsExporter read only.
+class SharedMemoryMetricsReader {
+public:
+  explicit SharedMemoryMetricsReader(const std::string &name) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+      return;
+    }
+
+    struct stat info {};
+    if (fstat(fd, &info) == 0 &&
+        static_cast<size_t>(info.st_size) >= sizeof(ShmMetricsSegment)) {
+      void *memory = mmap(nullptr, sizeof(ShmMetricsSegment), PROT_READ,
+                          MAP_SHARED, fd, 0);
+      if (memory != MAP_FAILED) {
+        m_segment = static_cast<const ShmMetricsSegment *>(memory);
+      }
+    }
+    close(fd);
+  }
+
+  SharedMemoryMetricsReader(const SharedMemoryMetricsReader &other) = delete;
+  SharedMemoryMetricsReader(SharedMemoryMetricsReader &&other) = delete;
+
+  ~SharedMemoryMetricsReader() {
+    if (m_segment != nullptr) {
+      munmap(const_cast<ShmMetricsSegment *>(m_segment),
+             sizeof(ShmMetricsSegment));
+    }
+  }
+
+  bool isOpen() const { return m_segment != nullptr; }
+
+  // Returns false if nothing was published yet, segment has another version,
+  // or writer kept it busy for all retries.
+  bool read(ShmMetrics &out, size_t maxRetries = 1000) const {
+    if (m_segment == nullptr || m_segment->_magic != shmMetricsMagic) {
+      return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (m_segment->_version != shmMetricsVersion) {
+      return false;
+    }
+
+    for (size_t retry = 0; retry < maxRetries; retry++) {
+      std::uint64_t before =
+          m_segment->_sequence.load(std::memory_order_acquire);
+      if (before == 0U) {
+        return false;
+      }
+      if ((before & 1U) != 0U) {
+        continue;
+      }
+
+      std::memcpy(&out, &m_segment->_metrics, sizeof(ShmMetrics));
+      std::atomic_thread_fence(std::memory_order_acquire);
+
+      if (m_segment->_sequence.load(std::memory_order_relaxed) == before) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  const ShmMetricsSegment *m_segment{nullptr};
+};
+
+} // namespace core
+} // namespace baltazar
+
+#endif // BALTAZAR_SHM_METRICS_HPP
@@ -1,9 +1,22 @@
+#include "../binary_trace.hpp"
 #include "../core_parallel.hpp"
 #include "../core_serial.hpp"
+#include "../histogram_profiling.hpp"
+#include "../lock_free_profiling.hpp"
+#include "../sampled_profiling.hpp"
+#include "../shm_metrics.hpp"
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <memory>
+#include <string>
 #include <thread>
+#include <unistd.h>
+#include <vector>
 
 namespace baltazar {
 
@@ -145,7 +158,7 @@ protected:
 
 TEST_F(CoreTest, RunSerialOnce) {
   // Arrange
-  std::atomic<bool> stopFlag;
+  std::atomic<bool> stopFlag{false};
   core::SerialCoreRunner runner{};
 
   // Act
@@ -160,7 +173,7 @@ TEST_F(CoreTest, RunSerialOnce) {
 
 TEST_F(CoreTest, RunSerialNTimes) {
   // Arrange
-  std::atomic<bool> stopFlag;
+  std::atomic<bool> stopFlag{false};
   constexpr size_t n = 16;
   core::SerialCoreRunner runner{};
 
@@ -193,9 +206,31 @@ TEST_F(CoreTest, RunSrialeInALoop) {
   EXPECT_TRUE(true);
 }
 
+TEST_F(CoreTest, RunStaticGraphSerialNTimes) {
+  // Arrange
+  using NodeA = dag::StaticNode<TaskA, 1, 2>;
+  using NodeB = dag::StaticNode<TaskB>;
+  using NodeC = dag::StaticNode<TaskC>;
+  using NodeD = dag::StaticNode<TaskD, 4, 5>;
+  using NodeE = dag::StaticNode<TaskE>;
+  using NodeF = dag::StaticNode<TaskF>;
+  using NodeG = dag::StaticNode<TaskG, 6, 3>;
+  dag::StaticGraph<NodeG, NodeB, NodeC, NodeD, NodeE, NodeF, NodeA> graph{
+      TaskG{}, TaskB{2}, TaskC{3.f}, TaskD{}, TaskE{2, 6}, TaskF{}, TaskA{}};
+  std::atomic<bool> stopFlag{false};
+  constexpr size_t n = 16;
+  core::SerialCoreRunner runner{};
+
+  // Act
+  runner.runNodeListSerialNTimes(graph, stopFlag, n);
+
+  // Assert
+  EXPECT_EQ(graph.getOutput<0>(), n * 13.0);
+}
+
 TEST_F(CoreTest, RunParallelOnce) {
   // Arrange
-  std::atomic<bool> stopFlag;
+  std::atomic<bool> stopFlag{false};
   threadPool::ThreadPool<2, 10> tPoll{};
   core::ParallelCoreRunner runner{};
 
@@ -211,7 +246,7 @@ TEST_F(CoreTest, RunParallelOnce) {
 
 TEST_F(CoreTest, RunParallelNTimes) {
   // Arrange
-  std::atomic<bool> stopFlag;
+  std::atomic<bool> stopFlag{false};
   constexpr size_t n = 16;
   threadPool::ThreadPool<2, 10> tPoll{};
   core::ParallelCoreRunner runner{};
@@ -226,6 +261,165 @@ TEST_F(CoreTest, RunParallelNTimes) {
   EXPECT_EQ(retValue, n * 13.0);
 }
 
+TEST_F(CoreTest, RunDynamicNodeListSerialAndParallelNTimes) {
+  // Arrange
+  constexpr size_t fanIn = 32;
+  constexpr size_t n = 16;
+  auto sum = [](dag::InputSpan<int> inputs) {
+    int ret = 0;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      ret += inputs[i];
+    }
+    return ret;
+  };
+  dag::DynamicNodeList nodeList{fanIn + 1};
+  auto *sumNode = nodeList.emplaceNode(sum, 0, fanIn);
+  for (size_t i = 0; i < fanIn; i++) {
+    sumNode->setDependencyAt(i, *nodeList.emplaceNode(TaskB{1}, i + 1));
+  }
+  nodeList.sortNodes(dag::SortType::Depth);
+
+  std::atomic<bool> stopFlag{false};
+  threadPool::ThreadPool<2, 10> tPoll{};
+  core::SerialCoreRunner serialRunner{};
+  core::ParallelCoreRunner parallelRunner{};
+
+  // Act
+  serialRunner.runNodeListSerialNTimes(nodeList, stopFlag, n);
+  int serialValue = *static_cast<int *>(sumNode->getOutputPtr());
+  *static_cast<int *>(sumNode->getOutputPtr()) = 0;
+  parallelRunner.runNodeListParallelNTimes(nodeList, tPoll, stopFlag, n);
+  int parallelValue = *static_cast<int *>(sumNode->getOutputPtr());
+
+  // Assert
+  EXPECT_EQ(serialValue, fanIn);
+  EXPECT_EQ(parallelValue, fanIn);
+}
+
+TEST_F(CoreTest, ProfilerSwitchesAtRuntime) {
+  // Arrange
+  std::atomic<bool> stopFlag{false};
+  std::ofstream unused;
+  threadPool::ThreadPool<2, 10> tPool{};
+  core::CoreThreadPool<2, 10, threadPool::NoInstrumentation>
+      uninstrumentedPool{};
+  core::ParallelCoreRunner<core::HistogramCoreProfiler<8>> runner{&unused,
+                                                                  false};
+  auto &profiler = runner.getProfiler();
+
+  // Act
+  runner.runNodeListParallelNTimes(this->getNodes(), tPool, stopFlag, 2);
+  core::LatencyStats offWaves = profiler.getWaveStats();
+
+  profiler.turnOn();
+  runner.runNodeListParallelNTimes(this->getNodes(), tPool, stopFlag, 3);
+  core::LatencyStats onWaves = profiler.getWaveStats();
+  core::LatencyStats onJobs = profiler.getStats(7, core::LatencyKind::Run);
+
+  runner.runNodeListParallelNTimes(this->getNodes(), uninstrumentedPool,
+                                   stopFlag, 2);
+  core::LatencyStats uninstrumentedWaves = profiler.getWaveStats();
+  core::LatencyStats uninstrumentedJobs =
+      profiler.getStats(7, core::LatencyKind::Run);
+
+  // Assert
+  EXPECT_EQ(offWaves._count, 0);
+  EXPECT_EQ(onWaves._count, 3);
+  EXPECT_EQ(onJobs._count, 3);
+  EXPECT_EQ(uninstrumentedWaves._count, 5);
+  EXPECT_EQ(uninstrumentedJobs._count, 3);
+}
+
+TEST_F(CoreTest, SampledProfilerKeepsExactTotals) {
+  // Arrange
+  using Sampled = core::SampledCoreProfiler<core::HistogramCoreProfiler<8>>;
+  std::atomic<bool> stopFlag{false};
+  std::ofstream unused;
+  threadPool::ThreadPool<2, 10> tPool{};
+  core::ParallelCoreRunner<Sampled> runner{&unused, true};
+  auto &profiler = runner.getProfiler();
+  profiler.setSamplingConfig({4, 0.0, core::microsecs{0}});
+
+  // Act
+  runner.runNodeListParallelNTimes(this->getNodes(), tPool, stopFlag, 10);
+  core::SamplingCounters counters = profiler.getCounters();
+  core::LatencyStats waves = profiler.getInner().getWaveStats();
+  core::LatencyStats jobs =
+      profiler.getInner().getStats(7, core::LatencyKind::Run);
+
+  // Assert
+  EXPECT_EQ(counters._waves, 10);
+  EXPECT_EQ(counters._jobs, 10 * this->getNodes().getNumberOfNodes());
+  EXPECT_EQ(counters._sampledWaves, 3);
+  EXPECT_EQ(counters._sampledJobs, 0);
+  EXPECT_EQ(waves._count, 3);
+  EXPECT_EQ(jobs._count, 0);
+}
+
+std::vector<core::TraceRecord> readJobRecords(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  core::TraceFileHeader header{};
+  in.read(reinterpret_cast<char *>(&header), sizeof(header));
+  std::vector<core::TraceRecord> jobs;
+  core::TraceRecord record{};
+  while (in.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+    if (record._type ==
+        static_cast<std::uint32_t>(core::TraceRecordType::Job)) {
+      jobs.push_back(record);
+    }
+  }
+  return jobs;
+}
+
+TEST_F(CoreTest, BinaryTraceTagsJobsWithTheirWave) {
+  // Arrange
+  using Trace = core::BinaryTraceCoreProfiler<64>;
+  const std::string path = "binary_trace_wave_test.bin";
+  const size_t numOfNodes = this->getNodes().getNumberOfNodes();
+  std::atomic<bool> stopFlag{false};
+
+  // Act
+  {
+    std::ofstream out(path, std::ios::binary);
+    core::SerialCoreRunner<Trace> runner{&out, true};
+    runner.runNodeListSerialOnce(this->getNodes(), stopFlag);
+    runner.getProfiler().turnOff();
+    runner.runNodeListSerialNTimes(this->getNodes(), stopFlag, 3);
+    runner.getProfiler().turnOn();
+    runner.runNodeListSerialOnce(this->getNodes(), stopFlag);
+  }
+  std::vector<core::TraceRecord> jobs = readJobRecords(path);
+  std::remove(path.c_str());
+
+  // Assert
+  ASSERT_EQ(jobs.size(), 2 * numOfNodes);
+  EXPECT_EQ(jobs.front()._wave, 1UL);
+  EXPECT_EQ(jobs.back()._wave, 5UL);
+}
+
+TEST_F(CoreTest, SampledBinaryTraceTagsJobsWithTheirWave) {
+  // Arrange
+  using Sampled = core::SampledCoreProfiler<core::BinaryTraceCoreProfiler<64>>;
+  const std::string path = "sampled_trace_wave_test.bin";
+  const size_t numOfNodes = this->getNodes().getNumberOfNodes();
+  std::atomic<bool> stopFlag{false};
+
+  // Act
+  {
+    std::ofstream out(path, std::ios::binary);
+    core::SerialCoreRunner<Sampled> runner{&out, true};
+    runner.getProfiler().setSamplingConfig({2, 1.0, core::microsecs{0}});
+    runner.runNodeListSerialNTimes(this->getNodes(), stopFlag, 4);
+  }
+  std::vector<core::TraceRecord> jobs = readJobRecords(path);
+  std::remove(path.c_str());
+
+  // Assert
+  ASSERT_EQ(jobs.size(), 2 * numOfNodes);
+  EXPECT_EQ(jobs.front()._wave, 1UL);
+  EXPECT_EQ(jobs.back()._wave, 3UL);
+}
+
 TEST_F(CoreTest, RunParallelInALoop) {
   // Arrange
   std::atomic<bool> stopFlag{false};
@@ -246,4 +440,211 @@ TEST_F(CoreTest, RunParallelInALoop) {
   EXPECT_TRUE(true);
 }
 
+TEST(LockFreeProfilerTest, EveryEventIsWrittenOrCountedAsDropped) {
+  // Arrange
+  constexpr size_t eventsPerThread = 2000UL;
+  const std::string path = "lock_free_profiler_test.log";
+  size_t dropped = 0UL;
+
+  // Act
+  {
+    std::ofstream out(path);
+    core::LockFreeCoreProfiler<64, 2> profiler{out, true};
+    // Producers stay alive until all are done, so none releases its ring.
+    std::atomic<size_t> finished{0UL};
+    auto produce = [&profiler, &finished]() {
+      for (size_t i = 0; i < eventsPerThread; i++) {
+        profiler.logWave(core::microsecs{1}, i);
+      }
+      finished++;
+      while (finished.load() < 3UL) {
+        std::this_thread::yield();
+      }
+    };
+    std::thread t1(produce);
+    std::thread t2(produce);
+    std::thread t3(produce);
+    t1.join();
+    t2.join();
+    t3.join();
+    dropped = profiler.getDroppedEvents();
+  }
+
+  std::ifstream in(path);
+  size_t written = 0UL;
+  for (std::string line; std::getline(in, line);) {
+    written += line.rfind("W, ", 0) == 0 ? 1UL : 0UL;
+  }
+  std::remove(path.c_str());
+
+  // Assert
+  EXPECT_GE(dropped, eventsPerThread);
+  EXPECT_EQ(written + dropped, 3UL * eventsPerThread);
+}
+
+TEST(LockFreeProfilerTest, ExitedThreadsReleaseTheirRings) {
+  // Arrange
+  constexpr size_t numOfThreads = 5UL;
+  const std::string path = "lock_free_profiler_release_test.log";
+  size_t dropped = 0UL;
+
+  // Act
+  {
+    std::ofstream out(path);
+    core::LockFreeCoreProfiler<64, 2> profiler{out, true};
+    for (size_t i = 0; i < numOfThreads; i++) {
+      std::thread t(
+          [&profiler, i] { profiler.logWave(core::microsecs{1}, i); });
+      t.join();
+    }
+    dropped = profiler.getDroppedEvents();
+  }
+
+  std::ifstream in(path);
+  size_t written = 0UL;
+  for (std::string line; std::getline(in, line);) {
+    written += line.rfind("W, ", 0) == 0 ? 1UL : 0UL;
+  }
+  std::remove(path.c_str());
+
+  // Assert
+  EXPECT_EQ(dropped, 0UL);
+  EXPECT_EQ(written, numOfThreads);
+}
+
+TEST(BinaryTraceProfilerTest, WritesHeaderAndFixedSizeRecords) {
+  // Arrange
+  const std::string path = "binary_trace_test.bin";
+
+  // Act
+  {
+    std::ofstream out(path, std::ios::binary);
+    core::BinaryTraceCoreProfiler<2> profiler{out, true};
+    profiler.logWave(core::microsecs{5}, 1UL);
+    profiler.logCustomDiff(core::microsecs{7}, 42UL);
+    profiler.logWave(core::microsecs{3}, 2UL);
+    profiler.logRun(core::microsecs{20});
+  }
+
+  std::ifstream in(path, std::ios::binary);
+  core::TraceFileHeader header{};
+  in.read(reinterpret_cast<char *>(&header), sizeof(header));
+  std::vector<core::TraceRecord> records(4);
+  in.read(reinterpret_cast<char *>(records.data()),
+          sizeof(core::TraceRecord) * records.size());
+  bool readAll = static_cast<bool>(in);
+  in.close();
+  std::remove(path.c_str());
+
+  // Assert
+  EXPECT_TRUE(readAll);
+  EXPECT_EQ(header._magic, core::traceMagic);
+  EXPECT_EQ(header._version, core::traceVersion);
+  EXPECT_EQ(header._recordSize, sizeof(core::TraceRecord));
+  EXPECT_EQ(records[0]._type,
+            static_cast<std::uint32_t>(core::TraceRecordType::Wave));
+  EXPECT_EQ(records[0]._index, 1UL);
+  EXPECT_EQ(records[0]._t1 - records[0]._t0, 5000);
+  EXPECT_EQ(records[1]._identifier, 42UL);
+  EXPECT_EQ(records[1]._wave, 1UL);
+  EXPECT_EQ(records[3]._type,
+            static_cast<std::uint32_t>(core::TraceRecordType::Run));
+  EXPECT_EQ(records[3]._t1 - records[3]._t0, 20000);
+}
+
+TEST(HistogramProfilerTest, WaveStatsAndSnapshotReset) {
+  // Arrange
+  std::ofstream unused;
+  core::HistogramCoreProfiler<4> profiler{unused, true};
+  std::unique_ptr<core::HistogramCoreProfiler<4>::Snapshot> snapshot;
+
+  // Act
+  for (size_t i = 1; i <= 100; i++) {
+    profiler.logWave(core::microsecs{i}, i);
+  }
+  core::LatencyStats before = profiler.getWaveStats();
+  profiler.snapshotAndReset(snapshot);
+  core::LatencyStats after = profiler.getWaveStats();
+  core::LatencyStats taskStats = profiler.getStats(0, core::LatencyKind::Run);
+
+  // Assert
+  EXPECT_EQ(before._count, 100);
+  EXPECT_EQ(before._max, 100000);
+  EXPECT_NEAR(static_cast<double>(before._p50), 50000.0, 50000.0 / 32.0);
+  EXPECT_EQ(snapshot->_wave.getCount(), 100);
+  EXPECT_EQ(after._count, 0);
+  EXPECT_EQ(taskStats._count, 0);
+}
+
+TEST(SharedMemoryMetricsTest, ReaderSeesPublishedMetrics) {
+  // Arrange
+  std::string name = "/baltazar_test_" + std::to_string(getpid());
+  core::SharedMemoryMetricsExporter exporter{name};
+  core::SharedMemoryMetricsReader reader{name};
+  core::LatencySnapshot<4> interval{};
+  threadPool::PoolMetrics<2> start{};
+  start._collected = true;
+  threadPool::PoolMetrics<2> pool{};
+  pool._collected = true;
+  core::ShmMetrics metrics{};
+  bool readBeforePublish = reader.read(metrics);
+
+  // Act
+  exporter.publish(core::LatencySnapshot<4>{}, start);
+  for (size_t i = 1; i <= 10; i++) {
+    interval._wave.record(i * 1000);
+    interval._tasks[2]._run.record(500);
+  }
+  pool._uptimeNs = 1000;
+  pool._workers[0] = {250, 0, 0, 7};
+  pool._workers[1] = {1000, 0, 0, 0};
+  pool._queueDepthSamples = 4;
+  pool._queueDepthSum = 6;
+  pool._maxQueueDepth = 3;
+  exporter.publish(interval, pool);
+  bool readAfterPublish = reader.read(metrics);
+
+  // Assert
+  ASSERT_TRUE(exporter.isOpen());
+  ASSERT_TRUE(reader.isOpen());
+  EXPECT_FALSE(readBeforePublish);
+  EXPECT_TRUE(readAfterPublish);
+  EXPECT_EQ(metrics._publishCount, 2);
+  EXPECT_EQ(metrics._wave._count, 10);
+  EXPECT_EQ(metrics._wave._maxNs, 10000);
+  EXPECT_GT(metrics._waveRate, 0.0);
+  EXPECT_EQ(metrics._numberOfNodes, 4);
+  EXPECT_EQ(metrics._nodes[2]._count, 10);
+  EXPECT_EQ(metrics._nodes[0]._count, 0);
+  EXPECT_EQ(metrics._numberOfWorkers, 2);
+  EXPECT_EQ(metrics._workers[0]._tasks, 7);
+  EXPECT_EQ(metrics._hasUtilization, 1U);
+  EXPECT_DOUBLE_EQ(metrics._workers[0]._utilization, 0.75);
+  EXPECT_DOUBLE_EQ(metrics._workers[1]._utilization, 0.0);
+  EXPECT_DOUBLE_EQ(metrics._meanQueueDepth, 1.5);
+  EXPECT_EQ(metrics._maxQueueDepth, 3);
+}
+
+TEST(SharedMemoryMetricsTest, UtilizationIsUnavailableWithPoolMetricsOff) {
+  // Arrange
+  std::string name = "/baltazar_test_off_" + std::to_string(getpid());
+  core::SharedMemoryMetricsExporter exporter{name};
+  core::SharedMemoryMetricsReader reader{name};
+  threadPool::ThreadPool<2, 10> tPool{};
+  core::ShmMetrics metrics{};
+
+  // Act
+  exporter.publish(core::LatencySnapshot<4>{}, tPool.getMetrics());
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  exporter.publish(core::LatencySnapshot<4>{}, tPool.getMetrics());
+  bool read = reader.read(metrics);
+
+  // Assert
+  ASSERT_TRUE(exporter.isOpen());
+  EXPECT_TRUE(read);
+  EXPECT_EQ(metrics._hasUtilization, 0U);
+  EXPECT_DOUBLE_EQ(metrics._workers[0]._utilization, 0.0);
+  EXPECT_DOUBLE_EQ(metrics._workers[1]._utilization, 0.0);
+}
+
 } // namespace baltazar
@@ -0,0 +1,91 @@
+#include "../shm_metrics.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+using baltazar::core::ShmMetrics;
+using baltazar::core::SharedMemoryMetricsReader;
+
+namespace {
+
+void printMetrics(const ShmMetrics &metrics) {
+  std::printf("publish %llu, interval %.1f ms\n",
+              static_cast<unsigned long long>(metrics._publishCount),
+              static_cast<double>(metrics._intervalNs) / 1e6);
+  std::printf("  waves %.1f/s, p50 %.1f us, p99 %.1f us, max %.1f us\n",
+              metrics._waveRate,
+              static_cast<double>(metrics._wave._p50Ns) / 1e3,
+              static_cast<double>(metrics._wave._p99Ns) / 1e3,
+              static_cast<double>(metrics._wave._maxNs) / 1e3);
+  std::printf("  queue depth mean %.2f, max %llu, rejections %llu\n",
+              metrics._meanQueueDepth,
+              static_cast<unsigned long long>(metrics._maxQueueDepth),
+              static_cast<unsigned long long>(metrics._rejections));
+
+  for (std::uint32_t i = 0; i < metrics._numberOfWorkers; i++) {
+    auto tasks = static_cast<unsigned long long>(metrics._workers[i]._tasks);
+    if (metrics._hasUtilization != 0U) {
+      std::printf("  worker %2u: %6llu tasks, %5.1f%% busy\n", i, tasks,
+                  100.0 * metrics._workers[i]._utilization);
+    } else {
+      std::printf("  worker %2u: %6llu tasks, busy n/a (pool metrics off)\n",
+                  i, tasks);
+    }
+  }
+
+  for (std::uint32_t i = 0; i < metrics._numberOfNodes; i++) {
+    const baltazar::core::ShmLatency &node = metrics._nodes[i];
+    if (node._count == 0) {
+      continue;
+    }
+    std::printf("  task %2u: %6llu runs, p50 %.1f us, p99 %.1f us\n", i,
+                static_cast<unsigned long long>(node._count),
+                static_cast<double>(node._p50Ns) / 1e3,
+                static_cast<double>(node._p99Ns) / 1e3);
+  }
+}
+
+} // namespace
+
+// Usage: baltazar_shm_metrics_reader /name [interval_ms] [--once]
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::printf("Usage: %s /segment_name [interval_ms] [--once]\n", argv[0]);
+    return 1;
+  }
+
+  std::string name = argv[1];
+  int intervalMs = 1000;
+  bool once = false;
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--once") {
+      once = true;
+    } else {
+      intervalMs = std::atoi(arg.c_str());
+    }
+  }
+
+  SharedMemoryMetricsReader reader{name};
+  if (!reader.isOpen()) {
+    std::printf("Segment %s can't be opened.\n", name.c_str());
+    return 1;
+  }
+
+  ShmMetrics metrics{};
+  std::uint64_t lastPublish = 0;
+  while (true) {
+    if (reader.read(metrics) && metrics._publishCount != lastPublish) {
+      lastPublish = metrics._publishCount;
+      printMetrics(metrics);
+      std::fflush(stdout);
+      if (once) {
+        return 0;
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+  }
+}
@@ -7,18 +7,62 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
-#include <functional>
 #include <tuple>
 #include <type_traits>
+#include <typeinfo>
 #include <unistd.h>
 #include <utility>
+#include <vector>
 
 namespace baltazar {
 namespace dag {
 
-template <size_t NUM_OF_EDGES, typename FUNCTOR> class Node;
+// Output policies decide how functor result is stored in node output.
+// AssignOutput: output = functor(args...), previous output is replaced.
+// ReuseOutput: functor has signature void(args..., OUTPUT &) and receives
+// previous wave's output to update in place, so heap buffers it owns (vector,
+// string, ...) are reused and steady state waves don't allocate.
+struct AssignOutput {};
+struct ReuseOutput {};
+
+template <typename FUNCTOR, typename OUTPUT_POLICY> struct OutputPolicyTraits;
+
+template <typename FUNCTOR>
+struct OutputPolicyTraits<FUNCTOR, AssignOutput> {
+  using Traits = utils::FunctionTraits<FUNCTOR>;
+  using Output = typename Traits::ReturnType;
+  using Args = typename Traits::ArgsTuple;
+  static constexpr size_t argsSize = Traits::ArgsSize;
+};
+
+template <typename FUNCTOR> struct OutputPolicyTraits<FUNCTOR, ReuseOutput> {
+  using Traits = utils::FunctionTraits<FUNCTOR>;
+  static_assert(Traits::ArgsSize > 0,
+                "Functor must take output reference as last argument.");
+  static_assert(std::is_void_v<typename Traits::ReturnType>,
+                "Functor must write into output reference and return void.");
+
+  using OutputArg =
+      std::tuple_element_t<Traits::ArgsSize - 1, typename Traits::ArgsTuple>;
+  static_assert(std::is_lvalue_reference_v<OutputArg> &&
+                    !std::is_const_v<std::remove_reference_t<OutputArg>>,
+                "Last functor argument must be a non-const reference.");
+
+  using Output = std::decay_t<OutputArg>;
+  using Args = decltype(utils::tupleHead<typename Traits::ArgsTuple>(
+      std::make_index_sequence<Traits::ArgsSize - 1>{}));
+  static constexpr size_t argsSize = Traits::ArgsSize - 1;
+};
+
+template <size_t NUM_OF_EDGES, typename FUNCTOR,
+          typename OUTPUT_POLICY = AssignOutput>
+class Node;
 template <size_t NUM_OF_NODES> class NodeList;
 
+namespace detail {
+class NodeSorter;
+} // namespace detail
+
 class INode : public threadPool::IThreadTask {
 public:
   virtual ~INode() = default;
@@ -28,6 +72,8 @@ public:
   virtual void setDone() = 0;
   virtual void reset() = 0;
   virtual void *getOutputPtr() = 0;
+  // Type behind getOutputPtr(), so runtime edges can be checked.
+  virtual const std::type_info &getOutputType() const = 0;
   virtual size_t numberOfDeps() = 0;
   virtual INode *getDepAt(size_t index) = 0;
   virtual void setPriority(size_t prio) = 0;
@@ -44,20 +90,22 @@ protected:
   virtual void resetVisited() = 0;
 
 private:
-  template <size_t N, typename F> friend class Node;
+  template <size_t N, typename F, typename P> friend class Node;
   template <size_t N> friend class NodeList;
+  friend class detail::NodeSorter;
 };
 
 struct Empty {};
 
-template <size_t NUM_OF_DEPS, typename FUNCTOR> class Node : public INode {
+template <size_t NUM_OF_DEPS, typename FUNCTOR, typename OUTPUT_POLICY>
+class Node : public INode {
 public:
-  using Traits = utils::FunctionTraits<FUNCTOR>;
-  using Output = typename Traits::ReturnType;
-  using Args = typename Traits::ArgsTuple;
+  using Traits = OutputPolicyTraits<FUNCTOR, OUTPUT_POLICY>;
+  using Output = typename Traits::Output;
+  using Args = typename Traits::Args;
   using StorageType =
       std::conditional_t<std::is_void_v<Output>, struct Empty, Output>;
-  static constexpr size_t argsSize = Traits::ArgsSize;
+  static constexpr size_t argsSize = Traits::argsSize;
 
   Node(const FUNCTOR &f, size_t identifer)
       : m_functor(f), m_identifier(identifer) {
@@ -72,12 +120,11 @@ public:
     }
   }
 
-  template <size_t I, size_t N, typename F>
-  void setDependencyAt(Node<N, F> &otherNode) {
+  template <size_t I, size_t N, typename F, typename P>
+  void setDependencyAt(Node<N, F, P> &otherNode) {
     static_assert((I >= 0) && (I < NUM_OF_DEPS), "Index is out of bounds.");
 
-    using OtherTraits = utils::FunctionTraits<F>;
-    using OtherOutput = typename OtherTraits::ReturnType;
+    using OtherOutput = typename Node<N, F, P>::Output;
     using ArgType = std::tuple_element_t<I, Args>;
 
     static_assert(std::is_convertible_v<ArgType, OtherOutput>,
@@ -112,7 +159,10 @@ public:
   }
 
   // INode functionality
-  void reset() override { m_ready = false; }
+  void reset() override {
+    m_ready = false;
+    m_done = false;
+  }
 
   // INode functionality
   void *getOutputPtr() override {
@@ -123,6 +173,11 @@ public:
     }
   }
 
+  // INode functionality
+  const std::type_info &getOutputType() const override {
+    return typeid(Output);
+  }
+
   // INode functionality
   INode *getDepAt(size_t index) override {
     assert(index < NUM_OF_DEPS && "Index out of bounds!");
@@ -174,15 +229,20 @@ protected:
 
 private:
   template <std::size_t... Is> void runImpl(std::index_sequence<Is...>) const {
-    if constexpr (!std::is_void_v<Output>) {
-      m_output = m_functor(*static_cast<std::tuple_element_t<Is, Args> *>(
-          m_deps[Is]->getOutputPtr())...);
+    if constexpr (std::is_same_v<OUTPUT_POLICY, ReuseOutput>) {
+      m_functor(*getDepOutput<Is>()..., m_output);
+    } else if constexpr (!std::is_void_v<Output>) {
+      m_output = m_functor(*getDepOutput<Is>()...);
     } else {
-      m_functor(*static_cast<std::tuple_element_t<Is, Args> *>(
-          m_deps[Is]->getOutputPtr())...);
+      m_functor(*getDepOutput<Is>()...);
     }
   }
 
+  template <std::size_t I> auto *getDepOutput() const {
+    return static_cast<std::decay_t<std::tuple_element_t<I, Args>> *>(
+        m_deps[I]->getOutputPtr());
+  }
+
   mutable FUNCTOR m_functor;
   std::array<INode *, NUM_OF_DEPS> m_deps;
   mutable bool m_ready{false};
@@ -204,95 +264,145 @@ enum class SortType {
   CustomPriority,
 };
 
-template <size_t NUM_OF_NODES> class NodeList {
-public:
-  NodeList() {}
-
-  void addNode(INode *node) {
-    assert(m_size < NUM_OF_NODES && "Index out of bounds!");
-    m_nodes[m_size] = node;
-    m_size++;
-  }
-
-  INode *getNodeAt(size_t index) {
-    assert(index < m_size && "Index out of bounds!");
-    return m_nodes[index];
-  }
-
-  size_t getNumberOfNodes() const { return m_size; }
-
-  void sortNodes(
-      SortType sortType = SortType::Topological,
-      std::function<bool(const INode *, const INode *)> customCompare =
-          [](const INode *, const INode *) { return false; }) {
-    std::array<INode *, NUM_OF_NODES> sortedNodes{};
-    size_t sortedNodesSize{0};
+namespace detail {
 
-    for (size_t nodeIndex = 0; nodeIndex < m_size; nodeIndex++) {
-      INode *currentNode = m_nodes[nodeIndex];
-      dfs(currentNode, sortedNodes, sortedNodesSize);
+// Iterative DFS over dependencies, so sorting doesn't depend on recursion depth
+// and runs in O(V + E). Depth is propagated in the same pass. Scratch
+// buffers are heap allocated because graphs can have millions of nodes.
+class NodeSorter {
+public:
+  template <typename COMPARE>
+  static void sortNodes(INode **nodes, size_t size, SortType sortType,
+                        COMPARE customCompare) {
+    std::vector<INode *> sortedNodes;
+    sortedNodes.reserve(size);
+    std::vector<DfsFrame> stack;
+
+    for (size_t nodeIndex = 0; nodeIndex < size; nodeIndex++) {
+      dfs(nodes[nodeIndex], sortedNodes, stack);
     }
 
+    assert(sortedNodes.size() == size &&
+           "Fatal error: Sorted and initial array sizes do not match!");
+
+    // Stable sorts keep topological order between equally ranked nodes.
     if (sortType == SortType::Depth) {
-      std::sort(sortedNodes.begin(), sortedNodes.end(),
-                [](const INode *a, const INode *b) {
-                  return a->getDepth() < b->getDepth();
-                });
+      std::stable_sort(sortedNodes.begin(), sortedNodes.end(),
+                       [](const INode *a, const INode *b) {
+                         return a->getDepth() < b->getDepth();
+                       });
     }
 
     if (sortType == SortType::Priority) {
-      std::sort(sortedNodes.begin(), sortedNodes.end(),
-                [](const INode *a, const INode *b) {
-                  return a->getPriority() > b->getPriority();
-                });
+      std::stable_sort(sortedNodes.begin(), sortedNodes.end(),
+                       [](const INode *a, const INode *b) {
+                         return a->getPriority() > b->getPriority();
+                       });
     }
 
     if (sortType == SortType::DepthOrPriority) {
-      std::sort(sortedNodes.begin(), sortedNodes.end(),
-                [](const INode *a, const INode *b) {
-                  if (a->getDepth() != b->getDepth()) {
-                    return a->getDepth() < b->getDepth();
-                  }
-                  return a->getPriority() > b->getPriority();
-                });
+      std::stable_sort(sortedNodes.begin(), sortedNodes.end(),
+                       [](const INode *a, const INode *b) {
+                         if (a->getDepth() != b->getDepth()) {
+                           return a->getDepth() < b->getDepth();
+                         }
+                         return a->getPriority() > b->getPriority();
+                       });
     }
 
     if (sortType == SortType::CustomPriority) {
-      assert(customCompare != nullptr && "Custom priority provided is null!");
-      std::sort(sortedNodes.begin(), sortedNodes.end(), customCompare);
+      std::stable_sort(sortedNodes.begin(), sortedNodes.end(), customCompare);
     }
 
-    assert(sortedNodesSize == m_size &&
-           "Fatal error: Sorted and initial array sizes do not match!");
-    for (size_t nodeIndex = 0; nodeIndex < sortedNodesSize; nodeIndex++) {
-      m_nodes[nodeIndex] = sortedNodes[nodeIndex];
-      m_nodes[nodeIndex]->resetVisited();
+    for (size_t nodeIndex = 0; nodeIndex < size; nodeIndex++) {
+      nodes[nodeIndex] = sortedNodes[nodeIndex];
+      nodes[nodeIndex]->resetVisited();
     }
   }
 
 private:
-  void dfs(INode *node, std::array<INode *, NUM_OF_NODES> &sortedNodes,
-           size_t &sortedNodesSize) const {
-    assert(!node->isActive() && "Cycle in graph detected!");
+  struct DfsFrame {
+    INode *_node;
+    size_t _nextDep;
+  };
+
+  static void dfs(INode *root, std::vector<INode *> &sortedNodes,
+                  std::vector<DfsFrame> &stack) {
+    assert(!root->isActive() && "Cycle in graph detected!");
 
-    if (node->isVisited()) {
+    if (root->isVisited()) {
       return;
     }
 
-    node->setVisited();
-    node->activate();
-    if (node->numberOfDeps() > 0) {
-      for (int depIndex = 0; depIndex < node->numberOfDeps(); ++depIndex) {
-        auto *depNode = node->getDepAt(depIndex);
-        dfs(depNode, sortedNodes, sortedNodesSize);
-        node->setDepth(std::max(node->getDepth(), depNode->getDepth() + 1UL));
+    root->setVisited();
+    root->activate();
+    stack.push_back({root, 0});
+
+    while (!stack.empty()) {
+      INode *node = stack.back()._node;
+      size_t depIndex = stack.back()._nextDep;
+
+      if (depIndex < node->numberOfDeps()) {
+        stack.back()._nextDep++;
+        INode *depNode = node->getDepAt(depIndex);
+        assert(!depNode->isActive() && "Cycle in graph detected!");
+
+        if (!depNode->isVisited()) {
+          depNode->setVisited();
+          depNode->activate();
+          stack.push_back({depNode, 0});
+          continue;
+        }
+
+        updateDepth(node, depNode);
+        continue;
+      }
+
+      node->deactivate();
+      sortedNodes.push_back(node);
+      stack.pop_back();
+
+      if (!stack.empty()) {
+        updateDepth(stack.back()._node, node);
       }
     }
-    node->deactivate();
-    sortedNodes[sortedNodesSize] = node;
-    sortedNodesSize++;
   }
 
+  static void updateDepth(INode *node, const INode *depNode) {
+    node->setDepth(std::max(node->getDepth(), depNode->getDepth() + 1UL));
+  }
+};
+
+} // namespace detail
+
+template <size_t NUM_OF_NODES> class NodeList {
+public:
+  NodeList() {}
+
+  void addNode(INode *node) {
+    assert(m_size < NUM_OF_NODES && "Index out of bounds!");
+    m_nodes[m_size] = node;
+    m_size++;
+  }
+
+  INode *getNodeAt(size_t index) {
+    assert(index < m_size && "Index out of bounds!");
+    return m_nodes[index];
+  }
+
+  size_t getNumberOfNodes() const { return m_size; }
+
+  void sortNodes(SortType sortType = SortType::Topological) {
+    sortNodes(sortType, [](const INode *, const INode *) { return false; });
+  }
+
+  template <typename COMPARE>
+  void sortNodes(SortType sortType, COMPARE customCompare) {
+    detail::NodeSorter::sortNodes(m_nodes.data(), m_size, sortType,
+                                  customCompare);
+  }
+
+private:
   std::array<INode *, NUM_OF_NODES> m_nodes;
   size_t m_size{0};
 };
@@ -0,0 +1,208 @@
+#ifndef BALTAZAR_DAG_GENERATOR_HPP
+#define BALTAZAR_DAG_GENERATOR_HPP
+
+#include "dynamic_dag.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace baltazar {
+namespace dag {
+
+enum class GraphShape {
+  // Layers of _width nodes, each depending on exactly min(_maxFanIn, _width)
+  // distinct nodes of the previous layer (at least one).
+  Layered,
+  // One root and all other nodes depending on it.
+  WideFanOut,
+  // Every node depends on the one before.
+  DeepChain,
+  // Root, independent middle nodes and a sink depending on all of them.
+  Diamond,
+  // Erdos-Renyi: every earlier node is a dependency with _edgeProbability,
+  // capped at _maxFanIn.
+  Random,
+};
+
+// Costs are in work units of generatedWork, see GeneratedTask.
+enum class CostDistribution { Constant, Uniform, Exponential, Bimodal };
+
+struct GraphSpec {
+  GraphShape _shape{GraphShape::Layered};
+  size_t _numberOfNodes{100};
+  size_t _width{10};
+  size_t _maxFanIn{4};
+  double _edgeProbability{0.05};
+  CostDistribution _cost{CostDistribution::Constant};
+  std::uint64_t _meanCost{0};
+  std::uint64_t _seed{1};
+};
+
+// Dependencies always point to lower indices, so index order is topological.
+struct GeneratedGraph {
+  std::vector<std::vector<size_t>> _deps;
+  std::vector<std::uint64_t> _costs;
+
+  size_t getNumberOfNodes() const { return _deps.size(); }
+
+  size_t getNumberOfEdges() const {
+    size_t edges = 0;
+    for (const auto &deps : _deps) {
+      edges += deps.size();
+    }
+    return edges;
+  }
+};
+
+namespace detail {
+
+inline void pickDeps(std::mt19937_64 &gen, size_t first, size_t last,
+                     size_t count, std::vector<size_t> &deps) {
+  count = std::min(count, last - first);
+  std::uniform_int_distribution<size_t> pick(first, last - 1);
+  while (deps.size() < count) {
+    size_t dep = pick(gen);
+    if (std::find(deps.begin(), deps.end(), dep) == deps.end()) {
+      deps.push_back(dep);
+    }
+  }
+  std::sort(deps.begin(), deps.end());
+}
+
+inline std::uint64_t drawCost(std::mt19937_64 &gen, CostDistribution cost,
+                              std::uint64_t mean) {
+  auto meanValue = static_cast<double>(mean);
+  switch (cost) {
+  case CostDistribution::Uniform:
+    return std::uniform_int_distribution<std::uint64_t>(0, 2 * mean)(gen);
+  case CostDistribution::Exponential:
+    return mean == 0 ? 0
+                     : static_cast<std::uint64_t>(
+                           std::exponential_distribution<double>(
+                               1.0 / meanValue)(gen));
+  case CostDistribution::Bimodal:
+    // 90% at half the mean and 10% at 5.5 times the mean.
+    return std::bernoulli_distribution(0.1)(gen)
+               ? static_cast<std::uint64_t>(5.5 * meanValue)
+               : mean / 2;
+  case CostDistribution::Constant:
+  default:
+    return mean;
+  }
+}
+
+} // namespace detail
+
+// Same spec and seed always give the same graph.
+inline GeneratedGraph generateGraph(const GraphSpec &spec) {
+  assert(spec._numberOfNodes > 0 && "Graph must have nodes!");
+  assert(spec._width > 0 && "Layer width must be positive!");
+
+  const size_t n = spec._numberOfNodes;
+  std::mt19937_64 gen(spec._seed);
+  GeneratedGraph graph;
+  graph._deps.resize(n);
+  graph._costs.resize(n);
+
+  for (size_t i = 0; i < n; i++) {
+    std::vector<size_t> &deps = graph._deps[i];
+    switch (spec._shape) {
+    case GraphShape::Layered: {
+      size_t layerStart = i - i % spec._width;
+      if (layerStart > 0) {
+        detail::pickDeps(gen, layerStart - spec._width, layerStart,
+                         std::max<size_t>(spec._maxFanIn, 1), deps);
+      }
+      break;
+    }
+    case GraphShape::WideFanOut:
+      if (i > 0) {
+        deps.push_back(0);
+      }
+      break;
+    case GraphShape::DeepChain:
+      if (i > 0) {
+        deps.push_back(i - 1);
+      }
+      break;
+    case GraphShape::Diamond:
+      if (i == 0) {
+        break;
+      }
+      if (i + 1 < n || i == 1) {
+        deps.push_back(0);
+      } else {
+        for (size_t dep = 1; dep < i; dep++) {
+          deps.push_back(dep);
+        }
+      }
+      break;
+    case GraphShape::Random: {
+      size_t count =
+          i == 0 ? 0
+                 : std::binomial_distribution<size_t>(
+                       i, spec._edgeProbability)(gen);
+      detail::pickDeps(gen, 0, i, std::min(count, spec._maxFanIn), deps);
+      break;
+    }
+    }
+    graph._costs[i] = detail::drawCost(gen, spec._cost, spec._meanCost);
+  }
+
+  return graph;
+}
+
+// Dependent multiply-add chain, about one work unit per few cycles. The
+// result feeds the node output, so the loop can't be dropped.
+inline std::uint64_t generatedWork(std::uint64_t value, std::uint64_t units) {
+  for (std::uint64_t i = 0; i < units; i++) {
+    value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+  }
+  return value;
+}
+
+class GeneratedTask {
+public:
+  explicit GeneratedTask(std::uint64_t cost) : m_cost(cost) {}
+
+  std::uint64_t operator()(InputSpan<std::uint64_t> inputs) {
+    std::uint64_t value = m_cost;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      value += inputs[i];
+    }
+    return generatedWork(value, m_cost);
+  }
+
+private:
+  std::uint64_t m_cost;
+};
+
+// Emplaces a GeneratedTask node per generated node, identifiers are indices.
+// Nodes are added in index order, which is already topological.
+inline void buildNodeList(const GeneratedGraph &graph,
+                          DynamicNodeList &nodes) {
+  assert(nodes.getCapacity() - nodes.getNumberOfNodes() >=
+             graph.getNumberOfNodes() &&
+         "Node list is too small!");
+
+  std::vector<DynamicNode<GeneratedTask> *> created;
+  created.reserve(graph.getNumberOfNodes());
+  for (size_t i = 0; i < graph.getNumberOfNodes(); i++) {
+    const std::vector<size_t> &deps = graph._deps[i];
+    auto *node =
+        nodes.emplaceNode(GeneratedTask{graph._costs[i]}, i, deps.size());
+    for (size_t d = 0; d < deps.size(); d++) {
+      node->setDependencyAt(d, *created[deps[d]]);
+    }
+    created.push_back(node);
+  }
+}
+
+} // namespace dag
+} // namespace baltazar
+
+#endif // BALTAZAR_DAG_GENERATOR_HPP
@@ -0,0 +1,285 @@
+#ifndef BALTAZAR_DYNAMIC_DAG_HPP
+#define BALTAZAR_DYNAMIC_DAG_HPP
+
+#include "../utils/arena.hpp"
+#include "../utils/function_traits.hpp"
+#include "dag.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+namespace baltazar {
+namespace dag {
+
+// Read-only view over outputs of a runtime number of dependencies. Functor
+// taking a single InputSpan<T> accepts any fan-in.
+template <typename T> class InputSpan {
+public:
+  using Value = T;
+
+  InputSpan(INode *const *deps, size_t size) : m_deps(deps), m_size(size) {}
+
+  size_t size() const { return m_size; }
+
+  const T &operator[](size_t index) const {
+    assert(index < m_size && "Index out of bounds!");
+    return *static_cast<const T *>(m_deps[index]->getOutputPtr());
+  }
+
+private:
+  INode *const *m_deps;
+  size_t m_size;
+};
+
+template <typename T> struct IsInputSpan : std::false_type {};
+template <typename T> struct IsInputSpan<InputSpan<T>> : std::true_type {};
+
+// Node with fan-in set at runtime. Node itself and its dependency array are
+// allocated from DynamicNodeList arena.
+template <typename FUNCTOR, typename OUTPUT_POLICY = AssignOutput>
+class DynamicNode : public INode {
+public:
+  using Traits = OutputPolicyTraits<FUNCTOR, OUTPUT_POLICY>;
+  using Output = typename Traits::Output;
+  using Args = typename Traits::Args;
+  using StorageType =
+      std::conditional_t<std::is_void_v<Output>, struct Empty, Output>;
+  static constexpr size_t argsSize = Traits::argsSize;
+
+  static constexpr bool hasRuntimeFanIn = [] {
+    if constexpr (argsSize == 1) {
+      return IsInputSpan<std::decay_t<std::tuple_element_t<0, Args>>>::value;
+    } else {
+      return false;
+    }
+  }();
+
+  DynamicNode(const FUNCTOR &f, size_t identifier, INode **deps,
+              size_t numberOfDeps)
+      : m_functor(f), m_deps(deps), m_numberOfDeps(numberOfDeps),
+        m_identifier(identifier) {
+    assert((hasRuntimeFanIn || numberOfDeps == argsSize) &&
+           "Number of dependencies doesn't match number of arguments!");
+  }
+
+  // Edges are only typed at runtime, so a mismatch is caught by an assert
+  // instead of reading another type's output.
+  void setDependencyAt(size_t index, INode &otherNode) {
+    assert(index < m_numberOfDeps && "Index out of bounds!");
+    assert(otherNode.getOutputType() == getArgType(index) &&
+           "Dependency output type doesn't match argument type!");
+    m_deps[index] = &otherNode;
+  }
+
+  // Output type a dependency at index has to have.
+  static const std::type_info &getArgType(size_t index) {
+    if constexpr (hasRuntimeFanIn) {
+      using Span = std::decay_t<std::tuple_element_t<0, Args>>;
+      return typeid(typename Span::Value);
+    } else {
+      return *argTypes(std::make_index_sequence<argsSize>{})[index];
+    }
+  }
+
+  // INode functionality
+  bool isReady() const override {
+    if (m_numberOfDeps == 0) {
+      return true;
+    }
+
+    if (m_ready) {
+      return m_ready;
+    }
+
+    m_ready = true;
+    for (size_t i = 0; i < m_numberOfDeps; i++) {
+      assert(m_deps[i] != nullptr && "One dependency is not set!");
+      if (!m_deps[i]->isDone()) {
+        m_ready = false;
+      }
+    }
+
+    return m_ready;
+  }
+
+  // INode functionality
+  void reset() override {
+    m_ready = false;
+    m_done = false;
+  }
+
+  // INode functionality
+  void *getOutputPtr() override {
+    if constexpr (std::is_void_v<Output>) {
+      return nullptr;
+    } else {
+      return &m_output;
+    }
+  }
+
+  // INode functionality
+  const std::type_info &getOutputType() const override {
+    return typeid(Output);
+  }
+
+  // INode functionality
+  INode *getDepAt(size_t index) override {
+    assert(index < m_numberOfDeps && "Index out of bounds!");
+    return m_deps[index];
+  }
+
+  // INode functionality
+  size_t numberOfDeps() override { return m_numberOfDeps; }
+
+  // INode functionality
+  void setPriority(size_t prio) override { m_prio = prio; }
+
+  // INode functionality
+  size_t getPriority() const override { return m_prio; }
+
+  // INode functionality
+  bool isDone() const override { return m_done; }
+
+  // INode functionality
+  void setDone() override { m_done = true; }
+
+  // INode functionality
+  void setDepth(size_t depth) override { m_depth = depth; }
+
+  // INode functionality
+  size_t getDepth() const override { return m_depth; }
+
+  // IThreadTask functionality
+  void run() const override {
+    assert(this->isReady() && "Node is not ready to run!");
+    if constexpr (hasRuntimeFanIn) {
+      using Span = std::decay_t<std::tuple_element_t<0, Args>>;
+      store(Span{m_deps, m_numberOfDeps});
+    } else {
+      runImpl(std::make_index_sequence<argsSize>{});
+    }
+  }
+
+  // IThreadTask functionality
+  size_t getIdentifier() const override { return m_identifier; }
+
+protected:
+  bool isActive() override { return m_active; }
+
+  bool isVisited() override { return m_visited; }
+
+  void setVisited() override { m_visited = true; }
+
+  void activate() override { m_active = true; }
+
+  void deactivate() override { m_active = false; }
+
+  void resetVisited() override { m_visited = false; }
+
+private:
+  template <std::size_t... Is>
+  static const std::array<const std::type_info *, argsSize> &
+  argTypes(std::index_sequence<Is...>) {
+    static const std::array<const std::type_info *, argsSize> types{
+        &typeid(std::decay_t<std::tuple_element_t<Is, Args>>)...};
+    return types;
+  }
+
+  template <std::size_t... Is> void runImpl(std::index_sequence<Is...>) const {
+    store(*static_cast<std::decay_t<std::tuple_element_t<Is, Args>> *>(
+        m_deps[Is]->getOutputPtr())...);
+  }
+
+  template <typename... ARGS> void store(ARGS &&...args) const {
+    if constexpr (std::is_same_v<OUTPUT_POLICY, ReuseOutput>) {
+      m_functor(std::forward<ARGS>(args)..., m_output);
+    } else if constexpr (!std::is_void_v<Output>) {
+      m_output = m_functor(std::forward<ARGS>(args)...);
+    } else {
+      m_functor(std::forward<ARGS>(args)...);
+    }
+  }
+
+  mutable FUNCTOR m_functor;
+  INode **m_deps;
+  size_t m_numberOfDeps;
+  mutable bool m_ready{false};
+  mutable StorageType m_output;
+  bool m_active{false};
+  bool m_visited{false};
+  bool m_done{false};
+  size_t m_depth{0};
+  size_t m_prio{0};
+  size_t m_identifier;
+};
+
+// Node list sized at runtime. Nodes, their dependency arrays and outputs are
+// bump allocated from one arena, so building a graph costs a few large
+// allocations and keeps nodes contiguous in memory. Arena blocks are sized
+// for capacity * bytesPerNode, which should cover node, its edges and output.
+class DynamicNodeList {
+public:
+  static constexpr size_t defaultBytesPerNode = 128UL;
+
+  explicit DynamicNodeList(size_t capacity,
+                           size_t bytesPerNode = defaultBytesPerNode)
+      : m_arena(std::max(utils::Arena::defaultBlockSize,
+                         capacity * (bytesPerNode + sizeof(INode *)))),
+        m_nodes(m_arena.allocateArray<INode *>(capacity)),
+        m_capacity(capacity) {}
+
+  template <typename OUTPUT_POLICY = AssignOutput, typename FUNCTOR>
+  DynamicNode<FUNCTOR, OUTPUT_POLICY> *
+  emplaceNode(const FUNCTOR &f, size_t identifier,
+              size_t numberOfDeps =
+                  DynamicNode<FUNCTOR, OUTPUT_POLICY>::argsSize) {
+    auto *node = m_arena.create<DynamicNode<FUNCTOR, OUTPUT_POLICY>>(
+        f, identifier, m_arena.allocateArray<INode *>(numberOfDeps),
+        numberOfDeps);
+    addNode(node);
+    return node;
+  }
+
+  void addNode(INode *node) {
+    assert(m_size < m_capacity && "Index out of bounds!");
+    m_nodes[m_size] = node;
+    m_size++;
+  }
+
+  INode *getNodeAt(size_t index) {
+    assert(index < m_size && "Index out of bounds!");
+    return m_nodes[index];
+  }
+
+  size_t getNumberOfNodes() const { return m_size; }
+
+  size_t getCapacity() const { return m_capacity; }
+
+  const utils::Arena &getArena() const { return m_arena; }
+
+  void sortNodes(SortType sortType = SortType::Topological) {
+    sortNodes(sortType, [](const INode *, const INode *) { return false; });
+  }
+
+  template <typename COMPARE>
+  void sortNodes(SortType sortType, COMPARE customCompare) {
+    detail::NodeSorter::sortNodes(m_nodes, m_size, sortType, customCompare);
+  }
+
+private:
+  utils::Arena m_arena;
+  INode **m_nodes;
+  size_t m_capacity;
+  size_t m_size{0};
+};
+
+} // namespace dag
+} // namespace baltazar
+
+#endif // BALTAZAR_DYNAMIC_DAG_HPP
@@ -0,0 +1,43 @@
+#ifndef BALTAZAR_EDGE_MAP_HPP
+#define BALTAZAR_EDGE_MAP_HPP
+
+#include "dag.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <ostream>
+#include <unordered_map>
+
+namespace baltazar {
+namespace dag {
+
+// Writes one line per node, "index: dep, dep", where indices are positions in
+// the node list. Runners use the same positions as job ids, so the output
+// lets analyze_critical_path.py connect trace records by edges. Nodes must be
+// sorted before, as sorting reorders the list.
+template <typename NODE_LIST>
+void writeEdgeMap(NODE_LIST &nodes, std::ostream &s) {
+  std::unordered_map<const INode *, size_t> indices;
+  for (size_t nodeIndex = 0; nodeIndex < nodes.getNumberOfNodes();
+       nodeIndex++) {
+    indices[nodes.getNodeAt(nodeIndex)] = nodeIndex;
+  }
+
+  for (size_t nodeIndex = 0; nodeIndex < nodes.getNumberOfNodes();
+       nodeIndex++) {
+    INode *node = nodes.getNodeAt(nodeIndex);
+    s << nodeIndex << ":";
+
+    for (size_t depIndex = 0; depIndex < node->numberOfDeps(); depIndex++) {
+      auto dep = indices.find(node->getDepAt(depIndex));
+      assert(dep != indices.end() && "Dependency is not in the node list!");
+      s << (depIndex == 0 ? " " : ", ") << dep->second;
+    }
+    s << "\n";
+  }
+}
+
+} // namespace dag
+} // namespace baltazar
+
+#endif // BALTAZAR_EDGE_MAP_HPP
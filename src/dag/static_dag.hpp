@@ -0,0 +1,201 @@
+#ifndef BALTAZAR_STATIC_DAG_HPP
+#define BALTAZAR_STATIC_DAG_HPP
+
+#include "../utils/function_traits.hpp"
+#include "dag.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace baltazar {
+namespace dag {
+
+// Node declared purely as a type. DEPS are positions of dependency nodes in
+// the StaticGraph node pack and map, in order, onto functor arguments.
+template <typename FUNCTOR, size_t... DEPS> struct StaticNode {
+  using Functor = FUNCTOR;
+  using Traits = utils::FunctionTraits<FUNCTOR>;
+  using Output = typename Traits::ReturnType;
+  using Args = typename Traits::ArgsTuple;
+  using StorageType =
+      std::conditional_t<std::is_void_v<Output>, struct Empty, Output>;
+
+  static constexpr size_t numberOfDeps = sizeof...(DEPS);
+  static constexpr std::array<size_t, sizeof...(DEPS)> deps{DEPS...};
+
+  static_assert(Traits::ArgsSize == sizeof...(DEPS),
+                "Number of dependencies doesn't match number of arguments.");
+};
+
+namespace detail {
+
+constexpr size_t staticCycleMarker = static_cast<size_t>(-1);
+
+template <typename NODE, size_t NUM_OF_NODES>
+constexpr void resolveStaticNode(size_t index,
+                                 std::array<size_t, NUM_OF_NODES> &depths,
+                                 std::array<bool, NUM_OF_NODES> &resolved,
+                                 size_t &resolvedNodes) {
+  if (resolved[index]) {
+    return;
+  }
+
+  size_t depth = 0;
+  for (size_t depIndex = 0; depIndex < NODE::numberOfDeps; depIndex++) {
+    size_t dep = NODE::deps[depIndex];
+    if (!resolved[dep]) {
+      return;
+    }
+    depth = std::max(depth, depths[dep] + 1);
+  }
+
+  depths[index] = depth;
+  resolved[index] = true;
+  resolvedNodes++;
+}
+
+// Every pass resolves at least one node unless the graph has a cycle, in which
+// case all depths are set to staticCycleMarker.
+template <typename... NODES>
+constexpr std::array<size_t, sizeof...(NODES)> computeStaticDepths() {
+  constexpr size_t numberOfNodes = sizeof...(NODES);
+  std::array<size_t, numberOfNodes> depths{};
+  std::array<bool, numberOfNodes> resolved{};
+
+  size_t resolvedNodes = 0;
+  for (size_t pass = 0; pass < numberOfNodes; pass++) {
+    size_t index = 0;
+    (resolveStaticNode<NODES>(index++, depths, resolved, resolvedNodes), ...);
+  }
+
+  if (resolvedNodes != numberOfNodes) {
+    for (size_t index = 0; index < numberOfNodes; index++) {
+      depths[index] = staticCycleMarker;
+    }
+  }
+
+  return depths;
+}
+
+// Sorted by depth, ties keep declaration order. Any depth ordering is also a
+// valid topological ordering.
+template <size_t NUM_OF_NODES>
+constexpr std::array<size_t, NUM_OF_NODES>
+computeStaticOrder(const std::array<size_t, NUM_OF_NODES> &depths) {
+  std::array<size_t, NUM_OF_NODES> order{};
+  size_t position = 0;
+  for (size_t depth = 0; depth < NUM_OF_NODES; depth++) {
+    for (size_t index = 0; index < NUM_OF_NODES; index++) {
+      if (depths[index] == depth) {
+        order[position] = index;
+        position++;
+      }
+    }
+  }
+  return order;
+}
+
+template <size_t NUM_OF_NODES, typename NODE> constexpr bool depsInRange() {
+  for (size_t depIndex = 0; depIndex < NODE::numberOfDeps; depIndex++) {
+    if (NODE::deps[depIndex] >= NUM_OF_NODES) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace detail
+
+// Graph whose shape is fully known at compile time. Topological order and
+// depth are computed with constexpr so running a wave is an inlined sequence
+// of functor calls without any virtual dispatch.
+template <typename... NODES> class StaticGraph {
+public:
+  static constexpr size_t numberOfNodes = sizeof...(NODES);
+
+  using Functors = std::tuple<typename NODES::Functor...>;
+  using Outputs = std::tuple<typename NODES::StorageType...>;
+
+  template <size_t I>
+  using NodeAt = std::tuple_element_t<I, std::tuple<NODES...>>;
+
+  static_assert((detail::depsInRange<sizeof...(NODES), NODES>() && ...),
+                "Dependency index is out of bounds.");
+
+  StaticGraph() = default;
+
+  explicit StaticGraph(const typename NODES::Functor &...functors)
+      : m_functors(functors...) {}
+
+  template <size_t I> auto &getFunctor() { return std::get<I>(m_functors); }
+
+  template <size_t I> auto &getOutput() { return std::get<I>(m_outputs); }
+
+  static constexpr size_t getNumberOfNodes() { return numberOfNodes; }
+
+  static constexpr size_t getDepth(size_t index) { return depths[index]; }
+
+  static constexpr size_t getNodeIndexAt(size_t position) {
+    return order[position];
+  }
+
+  // Runs every node once in topological order, stops early if stopFlag is
+  // raised. Returns number of nodes that were run.
+  size_t run(std::atomic<bool> &stopFlag) {
+    return runImpl(stopFlag, std::make_index_sequence<numberOfNodes>{});
+  }
+
+  static constexpr std::array<size_t, numberOfNodes> depths =
+      detail::computeStaticDepths<NODES...>();
+
+  static_assert(numberOfNodes == 0 ||
+                    depths[0] != detail::staticCycleMarker,
+                "Cycle in graph detected!");
+
+  static constexpr std::array<size_t, numberOfNodes> order =
+      detail::computeStaticOrder<numberOfNodes>(depths);
+
+private:
+  template <size_t... Is>
+  size_t runImpl(std::atomic<bool> &stopFlag, std::index_sequence<Is...>) {
+    size_t numberOfRunNodes = 0;
+    // Short circuits on the first node that observes stopFlag.
+    ((runNode<order[Is]>(), numberOfRunNodes++, !stopFlag) && ...);
+    return numberOfRunNodes;
+  }
+
+  template <size_t I> void runNode() {
+    using Node = NodeAt<I>;
+    runNodeImpl<I, Node>(std::make_index_sequence<Node::numberOfDeps>{});
+  }
+
+  template <size_t I, typename NODE, size_t... Is>
+  void runNodeImpl(std::index_sequence<Is...>) {
+    static_assert(
+        (std::is_convertible_v<
+             typename NodeAt<NODE::deps[Is]>::Output,
+             std::decay_t<std::tuple_element_t<Is, typename NODE::Args>>> &&
+         ...),
+        "Argument type doesn't match output type of edge node.");
+
+    if constexpr (std::is_void_v<typename NODE::Output>) {
+      std::get<I>(m_functors)(std::get<NODE::deps[Is]>(m_outputs)...);
+    } else {
+      std::get<I>(m_outputs) =
+          std::get<I>(m_functors)(std::get<NODE::deps[Is]>(m_outputs)...);
+    }
+  }
+
+  Functors m_functors;
+  Outputs m_outputs;
+};
+
+} // namespace dag
+} // namespace baltazar
+
+#endif // BALTAZAR_STATIC_DAG_HPP
@@ -1,9 +1,16 @@
 #include "../dag.hpp"
+#include "../dag_generator.hpp"
+#include "../dynamic_dag.hpp"
+#include "../edge_map.hpp"
+#include "../static_dag.hpp"
 #include "gtest/gtest.h"
 #include <array>
 #include <functional>
 #include <gtest/gtest.h>
+#include <memory>
 #include <ostream>
+#include <sstream>
+#include <typeinfo>
 #include <vector>
 
 namespace baltazar {
@@ -173,6 +180,41 @@ TEST(DagTest, ConnectFewNodesAndRunThemNonConvertibleTypes) {
   EXPECT_EQ(retValue[1], (*retPtr)[1]);
 }
 
+class TaskRepeat {
+public:
+  void operator()(std::string s, std::vector<std::string> &out) {
+    out.resize(64);
+    for (auto &value : out) {
+      value.assign(s.begin(), s.end());
+    }
+  }
+};
+
+TEST(DagTest, ConnectFewNodesAndReuseOutputBetweenRuns) {
+  // Arrange
+  TaskF taskF;
+  TaskRepeat taskRepeat;
+
+  dag::Node<0, TaskF> nodeF{taskF, indexMap["nodeF"]};
+  dag::Node<1, TaskRepeat, dag::ReuseOutput> nodeRepeat{taskRepeat, 1};
+  nodeRepeat.setDependencyAt<0>(nodeF);
+
+  auto *retPtr =
+      static_cast<std::vector<std::string> *>(nodeRepeat.getOutputPtr());
+
+  // Act
+  nodeF.run();
+  nodeF.setDone();
+  nodeRepeat.run();
+  const std::string *firstBuffer = retPtr->data();
+  nodeRepeat.run();
+
+  // Assert
+  EXPECT_EQ(retPtr->size(), 64);
+  EXPECT_EQ((*retPtr)[63], "mystring");
+  EXPECT_EQ(retPtr->data(), firstBuffer);
+}
+
 TEST(DagTest, CreateGraphAndGetSortedTasks) {
   // Arrange
   const std::array<size_t, 7> names{indexMap["nodeB"], indexMap["nodeC"],
@@ -510,4 +552,233 @@ TEST(DagTest, DetectsCycle) {
   EXPECT_DEATH({ nodeList.sortNodes(); }, ".*");
 }
 
+TEST(DagTest, CreateDeepChainAndGetSortedTasksPerDepth) {
+  // Arrange
+  constexpr size_t chainLength = 100000;
+  auto increment = [](int a) { return a + 1; };
+  TaskB taskB{0};
+
+  dag::Node<0, TaskB> source{taskB, 0};
+  std::vector<dag::Node<1, decltype(increment)>> chain;
+  chain.reserve(chainLength);
+  for (size_t i = 0; i < chainLength; i++) {
+    chain.emplace_back(increment, i + 1);
+    if (i == 0) {
+      chain[i].setDependencyAt<0>(source);
+    } else {
+      chain[i].setDependencyAt<0>(chain[i - 1]);
+    }
+  }
+
+  auto nodeList = std::make_unique<dag::NodeList<chainLength + 1>>();
+  for (size_t i = chainLength; i > 0; i--) {
+    nodeList->addNode(&chain[i - 1]);
+  }
+  nodeList->addNode(&source);
+
+  // Act
+  nodeList->sortNodes(dag::SortType::Depth);
+
+  // Assert
+  for (size_t i = 0; i < nodeList->getNumberOfNodes(); ++i) {
+    EXPECT_EQ(nodeList->getNodeAt(i)->getIdentifier(), i);
+    EXPECT_EQ(nodeList->getNodeAt(i)->getDepth(), i);
+  }
+}
+
+TEST(DagTest, CreateDynamicGraphWithRuntimeFanInAndRunIt) {
+  // Arrange
+  constexpr size_t fanIn = 5;
+  auto sum = [](dag::InputSpan<int> inputs) {
+    int ret = 0;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      ret += inputs[i];
+    }
+    return ret;
+  };
+  dag::DynamicNodeList nodeList{fanIn + 2};
+
+  // Act
+  auto *sumNode = nodeList.emplaceNode(sum, 1, fanIn);
+  auto *floatNode = nodeList.emplaceNode(TaskC{0.f}, 2);
+  for (size_t i = 0; i < fanIn; i++) {
+    auto *valueNode = nodeList.emplaceNode(TaskB{static_cast<int>(i)}, i + 3);
+    sumNode->setDependencyAt(i, *valueNode);
+  }
+  nodeList.sortNodes(dag::SortType::Depth);
+
+  for (size_t i = 0; i < nodeList.getNumberOfNodes(); i++) {
+    nodeList.getNodeAt(i)->run();
+    nodeList.getNodeAt(i)->setDone();
+  }
+
+  // Assert
+  EXPECT_EQ(*static_cast<int *>(sumNode->getOutputPtr()), 10);
+  EXPECT_EQ(sumNode->getDepth(), 1);
+  EXPECT_EQ(floatNode->getDepth(), 0);
+  EXPECT_EQ(nodeList.getNodeAt(fanIn + 1)->getIdentifier(), 1);
+  EXPECT_EQ(nodeList.getArena().getNumberOfBlocks(), 1);
+}
+
+TEST(DagTest, CreateDynamicGraphWithFixedArityNodesAndRunIt) {
+  // Arrange
+  dag::DynamicNodeList nodeList{3};
+
+  // Act
+  auto *nodeA = nodeList.emplaceNode(TaskA{}, indexMap["nodeA"]);
+  auto *nodeB = nodeList.emplaceNode(TaskB{2}, indexMap["nodeB"]);
+  auto *nodeC = nodeList.emplaceNode(TaskC{3.f}, indexMap["nodeC"]);
+  nodeA->setDependencyAt(0, *nodeB);
+  nodeA->setDependencyAt(1, *nodeC);
+  nodeList.sortNodes();
+
+  for (size_t i = 0; i < nodeList.getNumberOfNodes(); i++) {
+    nodeList.getNodeAt(i)->run();
+    nodeList.getNodeAt(i)->setDone();
+  }
+
+  // Assert
+  EXPECT_EQ(nodeA->numberOfDeps(), 2);
+  EXPECT_EQ(*static_cast<double *>(nodeA->getOutputPtr()), 5.0);
+}
+
+TEST(DagTest, ConnectDynamicNodesWithMismatchedOutputType) {
+  // Arrange
+  constexpr size_t fanIn = 2;
+  auto sum = [](dag::InputSpan<int> inputs) { return inputs.size(); };
+  dag::DynamicNodeList nodeList{4};
+  auto *nodeA = nodeList.emplaceNode(TaskA{}, indexMap["nodeA"]);
+  auto *nodeB = nodeList.emplaceNode(TaskB{2}, indexMap["nodeB"]);
+  auto *nodeC = nodeList.emplaceNode(TaskC{3.f}, indexMap["nodeC"]);
+  auto *sumNode = nodeList.emplaceNode(sum, 3, fanIn);
+
+  // Act & Assert
+  EXPECT_EQ(nodeB->getOutputType(), typeid(int));
+  EXPECT_EQ(nodeA->getArgType(0), typeid(int));
+  EXPECT_EQ(nodeA->getArgType(1), typeid(float));
+  EXPECT_EQ(sumNode->getArgType(1), typeid(int));
+  EXPECT_DEBUG_DEATH(nodeA->setDependencyAt(0, *nodeC), ".*");
+  EXPECT_DEBUG_DEATH(sumNode->setDependencyAt(1, *nodeC), ".*");
+}
+
+TEST(DagTest, WriteEdgeMapOfDynamicGraph) {
+  // Arrange
+  dag::DynamicNodeList nodeList{3};
+  auto *nodeA = nodeList.emplaceNode(TaskA{}, indexMap["nodeA"]);
+  auto *nodeB = nodeList.emplaceNode(TaskB{2}, indexMap["nodeB"]);
+  auto *nodeC = nodeList.emplaceNode(TaskC{3.f}, indexMap["nodeC"]);
+  nodeA->setDependencyAt(0, *nodeB);
+  nodeA->setDependencyAt(1, *nodeC);
+  std::ostringstream out;
+
+  // Act
+  dag::writeEdgeMap(nodeList, out);
+
+  // Assert
+  EXPECT_EQ(out.str(), "0: 1, 2\n1:\n2:\n");
+}
+
+TEST(DagTest, GenerateGraphsOfEveryShape) {
+  // Arrange
+  constexpr size_t numberOfNodes = 50;
+  dag::GraphSpec spec{};
+  spec._numberOfNodes = numberOfNodes;
+  spec._width = 5;
+  spec._maxFanIn = 3;
+  spec._edgeProbability = 0.2;
+  spec._cost = dag::CostDistribution::Uniform;
+  spec._meanCost = 10;
+
+  // Act
+  spec._shape = dag::GraphShape::Layered;
+  dag::GeneratedGraph layered = dag::generateGraph(spec);
+  dag::GeneratedGraph layeredAgain = dag::generateGraph(spec);
+  spec._shape = dag::GraphShape::WideFanOut;
+  dag::GeneratedGraph fanOut = dag::generateGraph(spec);
+  spec._shape = dag::GraphShape::DeepChain;
+  dag::GeneratedGraph chain = dag::generateGraph(spec);
+  spec._shape = dag::GraphShape::Diamond;
+  dag::GeneratedGraph diamond = dag::generateGraph(spec);
+  spec._shape = dag::GraphShape::Random;
+  dag::GeneratedGraph random = dag::generateGraph(spec);
+
+  dag::DynamicNodeList nodeList{numberOfNodes};
+  dag::buildNodeList(random, nodeList);
+  nodeList.sortNodes(dag::SortType::Depth);
+  for (size_t i = 0; i < nodeList.getNumberOfNodes(); i++) {
+    nodeList.getNodeAt(i)->run();
+    nodeList.getNodeAt(i)->setDone();
+  }
+
+  // Assert
+  EXPECT_EQ(layered._deps, layeredAgain._deps);
+  EXPECT_EQ(layered._costs, layeredAgain._costs);
+  EXPECT_EQ(layered._deps[4].size(), 0);
+  EXPECT_EQ(layered._deps[7].size(), 3);
+  EXPECT_EQ(fanOut._deps[0].size(), 0);
+  EXPECT_EQ(fanOut.getNumberOfEdges(), numberOfNodes - 1);
+  EXPECT_EQ(chain.getNumberOfEdges(), numberOfNodes - 1);
+  EXPECT_EQ(diamond._deps[numberOfNodes - 1].size(), numberOfNodes - 2);
+  for (size_t i = 0; i < numberOfNodes; i++) {
+    EXPECT_LE(random._deps[i].size(), spec._maxFanIn);
+    if (i > 0) {
+      EXPECT_EQ(fanOut._deps[i], std::vector<size_t>{0});
+    }
+    for (size_t dep : random._deps[i]) {
+      EXPECT_LT(dep, i);
+    }
+    EXPECT_LE(layered._costs[i], 2 * spec._meanCost);
+  }
+  EXPECT_EQ(nodeList.getNumberOfNodes(), numberOfNodes);
+  EXPECT_TRUE(nodeList.getNodeAt(numberOfNodes - 1)->isDone());
+}
+
+TEST(DagTest, CreateStaticGraphAndGetSortedTasksPerDepth) {
+  // Arrange
+  using NodeG = dag::StaticNode<TaskG, 6, 3>;
+  using NodeE = dag::StaticNode<TaskE>;
+  using NodeC = dag::StaticNode<TaskC>;
+  using NodeD = dag::StaticNode<TaskD, 1, 4>;
+  using NodeF = dag::StaticNode<TaskF>;
+  using NodeB = dag::StaticNode<TaskB>;
+  using NodeA = dag::StaticNode<TaskA, 5, 2>;
+  using Graph =
+      dag::StaticGraph<NodeG, NodeE, NodeC, NodeD, NodeF, NodeB, NodeA>;
+
+  // Act
+  constexpr std::array<size_t, 7> order = Graph::order;
+  constexpr std::array<size_t, 7> depths = Graph::depths;
+
+  // Assert
+  static_assert(Graph::getNodeIndexAt(6) == 0, "Sink must be run last.");
+  const std::array<size_t, 7> expectedOrder{1, 2, 4, 5, 3, 6, 0};
+  const std::array<size_t, 7> expectedDepths{2, 0, 0, 1, 0, 0, 1};
+  for (size_t i = 0; i < Graph::getNumberOfNodes(); ++i) {
+    EXPECT_EQ(order[i], expectedOrder[i]);
+    EXPECT_EQ(depths[i], expectedDepths[i]);
+  }
+}
+
+TEST(DagTest, CreateStaticGraphAndRunIt) {
+  // Arrange
+  using NodeA = dag::StaticNode<TaskA, 1, 2>;
+  using NodeB = dag::StaticNode<TaskB>;
+  using NodeC = dag::StaticNode<TaskC>;
+  using NodeD = dag::StaticNode<TaskD, 4, 5>;
+  using NodeE = dag::StaticNode<TaskE>;
+  using NodeF = dag::StaticNode<TaskF>;
+  using NodeG = dag::StaticNode<TaskG, 0, 3>;
+  dag::StaticGraph<NodeA, NodeB, NodeC, NodeD, NodeE, NodeF, NodeG> graph{
+      TaskA{}, TaskB{2}, TaskC{3.f}, TaskD{}, TaskE{2, 3}, TaskF{}, TaskG{}};
+  std::atomic<bool> stopFlag{false};
+
+  // Act
+  size_t numberOfRunNodes = graph.run(stopFlag);
+
+  // Assert
+  EXPECT_EQ(numberOfRunNodes, 7);
+  EXPECT_EQ(graph.getOutput<0>(), 5.0);
+  EXPECT_EQ(graph.getOutput<6>(), 10.0);
+}
+
 } // namespace baltazar
@@ -0,0 +1,202 @@
+#include "../../utils/log_linear_histogram.hpp"
+#include "../thread_pool.hpp"
+#include "../thread_task_queue.hpp"
+
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+// Queue and pool under contention. Producers are benchmark threads, workers
+// are pool threads; all tasks are no-ops so only the handoff is measured.
+namespace baltazar {
+
+class NoOpTask final : public threadPool::IThreadTask {
+public:
+  void run() const override {}
+
+  size_t getIdentifier() const override { return 0; }
+};
+
+// Shared by all producers, so jobs queued by a finished producer thread stay
+// valid until the pool drains.
+NoOpTask noOpTask{};
+
+using NoOpJob = threadPool::BasicThreadJob<threadPool::NoInstrumentation>;
+
+// Instrumented jobs are timed and synced, so their timestamps come back
+// through getNextDoneTask().
+template <typename INSTRUMENTATION = threadPool::NoInstrumentation>
+threadPool::BasicThreadJob<INSTRUMENTATION> noOpJob(size_t id = 0) {
+  threadPool::BasicThreadJob<INSTRUMENTATION> job{};
+  job._task = &noOpTask;
+  job._id = id;
+  job._shouldSyncWhenDone = INSTRUMENTATION::enabled;
+  if constexpr (INSTRUMENTATION::enabled) {
+    job._profiled = true;
+  }
+  return job;
+}
+
+// Bare ring buffer, the lower bound for anything built on it.
+template <size_t QUEUE_SIZE>
+// NOLINTNEXTLINE
+static void BM_TaskQueuePushPop(benchmark::State &state) {
+  threadPool::TaskQueue<QUEUE_SIZE, NoOpJob> queue;
+
+  for (auto _ : state) {
+    bool pushed = queue.push(noOpJob());
+    benchmark::DoNotOptimize(pushed);
+    benchmark::DoNotOptimize(queue.pop());
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_TaskQueuePushPop, 16);
+BENCHMARK_TEMPLATE(BM_TaskQueuePushPop, 256);
+
+// Queue behind one mutex, the way ThreadPool guards it, hit by every
+// benchmark thread.
+template <size_t QUEUE_SIZE>
+// NOLINTNEXTLINE
+static void BM_LockedTaskQueuePushPop(benchmark::State &state) {
+  static threadPool::TaskQueue<QUEUE_SIZE, NoOpJob> queue;
+  static std::mutex mtx;
+
+  for (auto _ : state) {
+    {
+      std::lock_guard lock(mtx);
+      bool pushed = queue.push(noOpJob());
+      benchmark::DoNotOptimize(pushed);
+    }
+    {
+      std::lock_guard lock(mtx);
+      benchmark::DoNotOptimize(queue.pop());
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_LockedTaskQueuePushPop, 256)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+// Pool shared by all producer threads of one benchmark run. Thread 0 creates
+// it before the first iteration and tears it down after the last one.
+template <size_t WORKERS, size_t QUEUE_SIZE> struct SharedPool {
+  using Pool = threadPool::ThreadPool<WORKERS, QUEUE_SIZE, NoOpJob>;
+
+  static void setUp(const benchmark::State &state) {
+    if (state.thread_index() == 0) {
+      pool = std::make_unique<Pool>();
+    }
+  }
+
+  static void tearDown(const benchmark::State &state) {
+    if (state.thread_index() == 0) {
+      std::atomic<bool> stop{false};
+      pool->waitForAllTasks(stop);
+      pool.reset();
+    }
+  }
+
+  static inline std::unique_ptr<Pool> pool;
+};
+
+// Blocking producers: scheduleTask waits while the pool is full.
+template <size_t WORKERS, size_t QUEUE_SIZE>
+// NOLINTNEXTLINE
+static void BM_ScheduleTaskThroughput(benchmark::State &state) {
+  using Shared = SharedPool<WORKERS, QUEUE_SIZE>;
+  Shared::setUp(state);
+
+  for (auto _ : state) {
+    Shared::pool->scheduleTask(noOpJob());
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  Shared::tearDown(state);
+}
+BENCHMARK_TEMPLATE(BM_ScheduleTaskThroughput, 1, 16)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ScheduleTaskThroughput, 4, 16)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ScheduleTaskThroughput, 4, 256)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ScheduleTaskThroughput, 8, 256)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+// Non-blocking producers: reports how often tryScheduleTask finds the pool
+// full, averaged over producer threads.
+template <size_t WORKERS, size_t QUEUE_SIZE>
+// NOLINTNEXTLINE
+static void BM_TryScheduleTaskRejections(benchmark::State &state) {
+  using Shared = SharedPool<WORKERS, QUEUE_SIZE>;
+  Shared::setUp(state);
+  std::int64_t accepted = 0;
+
+  for (auto _ : state) {
+    accepted += Shared::pool->tryScheduleTask(noOpJob()) ? 1 : 0;
+  }
+
+  auto attempts = static_cast<double>(state.iterations());
+  state.SetItemsProcessed(accepted);
+  state.counters["rejection_rate"] = benchmark::Counter(
+      (attempts - static_cast<double>(accepted)) / attempts,
+      benchmark::Counter::kAvgThreads);
+  Shared::tearDown(state);
+}
+BENCHMARK_TEMPLATE(BM_TryScheduleTaskRejections, 4, 4)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_TryScheduleTaskRejections, 4, 16)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_TryScheduleTaskRejections, 4, 256)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+// Time from scheduleTask to a worker starting the job, taken from job
+// timestamps. Argument is the number of jobs in flight: 1 measures waking an
+// idle worker, larger batches include queueing behind other jobs.
+template <size_t WORKERS>
+// NOLINTNEXTLINE
+static void BM_HandoffLatency(benchmark::State &state) {
+  threadPool::ThreadPool<WORKERS, 256> tPool{};
+  utils::LogLinearHistogram<5, 40> latency;
+  const auto batch = static_cast<size_t>(state.range(0));
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < batch; i++) {
+      tPool.scheduleTask(noOpJob<threadPool::RuntimeInstrumentation>(i));
+    }
+    for (size_t i = 0; i < batch; i++) {
+      threadPool::ThreadJob job = tPool.getNextDoneTask().value();
+      latency.record(static_cast<std::uint64_t>(
+          utils::elapsed<std::chrono::nanoseconds>(job._scheduledTimePoint,
+                                                   job._startedTimePoint)
+              .count()));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(batch));
+  state.counters["p50_ns"] =
+      static_cast<double>(latency.valueAtPercentile(50.0));
+  state.counters["p99_ns"] =
+      static_cast<double>(latency.valueAtPercentile(99.0));
+  state.counters["max_ns"] = static_cast<double>(latency.getMax());
+}
+BENCHMARK_TEMPLATE(BM_HandoffLatency, 1)->Arg(1)->Arg(64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_HandoffLatency, 2)->Arg(1)->Arg(64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_HandoffLatency, 4)->Arg(1)->Arg(64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_HandoffLatency, 8)->Arg(1)->Arg(64)->UseRealTime();
+
+} // namespace baltazar
+
+BENCHMARK_MAIN();
@@ -0,0 +1,108 @@
+#ifndef BALTAZAR_INLINE_TASK_HPP
+#define BALTAZAR_INLINE_TASK_HPP
+
+#include "../utils/clock.hpp"
+#include "instrumentation.hpp"
+#include "thread_task.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace baltazar {
+namespace threadPool {
+
+// Type-erased callable stored by value: a function pointer plus fixed inline
+// storage. Only trivially copyable and destructible callables are accepted so
+// jobs can be copied through the queue as plain bytes, with no destroy or
+// move pointers. Default storage fits one pointer, e.g. a node thunk.
+template <size_t CAPACITY = sizeof(void *)> class InlineTask {
+public:
+  InlineTask() = default;
+
+  template <typename FUNCTOR,
+            typename = std::enable_if_t<
+                !std::is_same_v<std::decay_t<FUNCTOR>, InlineTask>>>
+  InlineTask(const FUNCTOR &f) // NOLINT
+      : m_invoke(&invoke<FUNCTOR>) {
+    static_assert(sizeof(FUNCTOR) <= CAPACITY,
+                  "Callable doesn't fit into inline storage.");
+    static_assert(alignof(FUNCTOR) <= alignof(void *),
+                  "Callable is over-aligned for inline storage.");
+    static_assert(std::is_trivially_copyable_v<FUNCTOR> &&
+                      std::is_trivially_destructible_v<FUNCTOR>,
+                  "Callable must be trivially copyable and destructible.");
+
+    new (m_storage) FUNCTOR(f);
+  }
+
+  void run() const { m_invoke(m_storage); }
+
+  explicit operator bool() const { return m_invoke != nullptr; }
+
+private:
+  template <typename FUNCTOR> static void invoke(void *storage) {
+    (*std::launder(reinterpret_cast<FUNCTOR *>(storage)))();
+  }
+
+  void (*m_invoke)(void *){nullptr};
+  alignas(void *) mutable unsigned char m_storage[CAPACITY]{};
+};
+
+// Job carrying an InlineTask, identified by _id. Timestamps are only part of
+// the layout when INSTRUMENTATION is RuntimeInstrumentation, which the pool
+// requires to timestamp jobs.
+template <size_t CAPACITY = sizeof(void *),
+          typename INSTRUMENTATION = NoInstrumentation>
+struct InlineThreadJob {
+  using Instrumentation = INSTRUMENTATION;
+
+  InlineTask<CAPACITY> _task;
+  size_t _id;
+  bool _shouldSyncWhenDone;
+};
+
+template <size_t CAPACITY>
+struct InlineThreadJob<CAPACITY, RuntimeInstrumentation> {
+  using Instrumentation = RuntimeInstrumentation;
+
+  InlineTask<CAPACITY> _task;
+  size_t _id;
+  bool _shouldSyncWhenDone;
+  bool _profiled{false};
+  utils::ProfilingClock::time_point _scheduledTimePoint{};
+  utils::ProfilingClock::time_point _startedTimePoint{};
+  utils::ProfilingClock::time_point _endedTimePoint{};
+  utils::ProfilingClock::time_point _syncedTimePoint{};
+  size_t _threadId{0};
+};
+
+// Only the inline storage is added to the uninstrumented job, in place of the
+// caller owned IThreadTask it would point to.
+static_assert(sizeof(InlineThreadJob<>) <=
+                  sizeof(BasicThreadJob<NoInstrumentation>) + sizeof(void *),
+              "Inline job should only add its storage to ThreadJob.");
+
+template <size_t CAPACITY, typename INSTRUMENTATION>
+inline void
+runThreadJob(const InlineThreadJob<CAPACITY, INSTRUMENTATION> &job) {
+  job._task.run();
+}
+
+template <size_t CAPACITY, typename INSTRUMENTATION>
+inline size_t
+getThreadJobIdentifier(const InlineThreadJob<CAPACITY, INSTRUMENTATION> &job) {
+  return job._id;
+}
+
+template <size_t CAPACITY, typename INSTRUMENTATION>
+inline bool
+isThreadJobValid(const InlineThreadJob<CAPACITY, INSTRUMENTATION> &job) {
+  return static_cast<bool>(job._task);
+}
+
+} // namespace threadPool
+} // namespace baltazar
+
+#endif // BALTAZAR_INLINE_TASK_HPP
@@ -0,0 +1,22 @@
+#ifndef BALTAZAR_INSTRUMENTATION_HPP
+#define BALTAZAR_INSTRUMENTATION_HPP
+
+namespace baltazar {
+namespace threadPool {
+
+// Compile-time instrumentation policies for ThreadPool. NoInstrumentation
+// compiles job timestamping out entirely. RuntimeInstrumentation timestamps
+// jobs scheduled with _profiled set and costs one branch per job otherwise.
+// Scheduler metrics are switched separately with ThreadPool::turnMetricsOn().
+struct NoInstrumentation {
+  static constexpr bool enabled = false;
+};
+
+struct RuntimeInstrumentation {
+  static constexpr bool enabled = true;
+};
+
+} // namespace threadPool
+} // namespace baltazar
+
+#endif // BALTAZAR_INSTRUMENTATION_HPP
@@ -0,0 +1,87 @@
+#ifndef BALTAZAR_POOL_METRICS_HPP
+#define BALTAZAR_POOL_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace baltazar {
+namespace threadPool {
+
+// Counters are written with relaxed atomics, so a snapshot taken while the
+// pool is running is not consistent across fields. Times are in nanoseconds.
+struct WorkerMetrics {
+  // Time spent waiting for a job while the queue was empty.
+  std::uint64_t _idleNs;
+  std::uint64_t _wakeups;
+  // Wake-ups that found no job, including ones lost to another worker.
+  std::uint64_t _spuriousWakeups;
+  std::uint64_t _tasks;
+};
+
+template <size_t THREAD_NUM> struct PoolMetrics {
+  std::array<WorkerMetrics, THREAD_NUM> _workers;
+  // Time since the pool was created, to relate idle times to.
+  std::uint64_t _uptimeNs;
+  // scheduleTask() calls that had to wait for a free slot and how long.
+  std::uint64_t _producerWaits;
+  std::uint64_t _producerWaitNs;
+  // tryScheduleTask() calls refused because the pool was full.
+  std::uint64_t _rejections;
+  // Queue depth seen right after every successful schedule.
+  std::uint64_t _queueDepthSamples;
+  std::uint64_t _queueDepthSum;
+  std::uint64_t _maxQueueDepth;
+  // Metrics were on when the snapshot was taken. Counters don't move while
+  // they are off, so idle times only cover the time they were on.
+  bool _collected;
+};
+
+namespace detail {
+
+// Counter with a single writer, so increments don't need a locked
+// read-modify-write.
+class RelaxedCounter {
+public:
+  void add(std::uint64_t value) {
+    m_value.store(m_value.load(std::memory_order_relaxed) + value,
+                  std::memory_order_relaxed);
+  }
+
+  void max(std::uint64_t value) {
+    if (value > m_value.load(std::memory_order_relaxed)) {
+      m_value.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  std::uint64_t get() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<std::uint64_t> m_value{0};
+};
+
+// Each worker writes its own cache line.
+struct alignas(64) WorkerCounters {
+  RelaxedCounter _idleNs;
+  RelaxedCounter _wakeups;
+  RelaxedCounter _spuriousWakeups;
+  RelaxedCounter _tasks;
+};
+
+// Written under pool mutex by producers and the syncing thread.
+struct alignas(64) ProducerCounters {
+  RelaxedCounter _waits;
+  RelaxedCounter _waitNs;
+  RelaxedCounter _rejections;
+  RelaxedCounter _queueDepthSamples;
+  RelaxedCounter _queueDepthSum;
+  RelaxedCounter _maxQueueDepth;
+};
+
+} // namespace detail
+
+} // namespace threadPool
+} // namespace baltazar
+
+#endif // BALTAZAR_POOL_METRICS_HPP
@@ -1,3 +1,4 @@
+#include "../inline_task.hpp"
 #include "../thread_pool.hpp"
 #include "thread_task.hpp"
 #include <chrono>
@@ -214,4 +215,136 @@ TEST(ThreadPoolTest, CreateThreadsWithManyTasksAndWaitForDoneTasks) {
   EXPECT_EQ(doneTaskCounter, numOfTasks / 2);
 }
 
+TEST(ThreadPoolTest, RunInlineTaskWithCapturedContext) {
+  // Arrange
+  std::atomic<size_t> testCounter{0};
+  auto *counterPtr = &testCounter;
+  threadPool::InlineTask<> task{[counterPtr] { ++*counterPtr; }};
+
+  // Act
+  task.run();
+  task.run();
+
+  // Assert
+  EXPECT_TRUE(static_cast<bool>(task));
+  EXPECT_FALSE(static_cast<bool>(threadPool::InlineTask<>{}));
+  EXPECT_EQ(testCounter.load(), 2);
+}
+
+TEST(ThreadPoolTest, CreateThreadsWithManyInlineTasksAndWaitForDoneTasks) {
+  // Arrange
+  constexpr size_t numThreads = 2;
+  constexpr size_t numOfTasks = 10;
+  std::atomic<size_t> testCounter{0};
+  auto *counterPtr = &testCounter;
+
+  threadPool::ThreadPool<numThreads, 10, threadPool::InlineThreadJob<>>
+      threadPool{};
+
+  // Act
+  int counter = 0;
+  for (int i = 0; i < numOfTasks; i++) {
+    threadPool::InlineThreadJob<> job{
+        [counterPtr] { ++*counterPtr; }, static_cast<size_t>(i), true};
+    if (threadPool.scheduleTask(job)) {
+      counter++;
+    }
+  }
+
+  // Assert
+  size_t identifierSum = 0;
+  for (int i = 0; i < numOfTasks; i++) {
+    auto doneTask = threadPool.getNextDoneTask();
+    EXPECT_TRUE(doneTask.has_value());
+    identifierSum += threadPool::getThreadJobIdentifier(doneTask.value());
+  }
+
+  std::atomic stop{false};
+  threadPool.waitForAllTasks(stop);
+
+  EXPECT_EQ(counter, numOfTasks);
+  EXPECT_EQ(testCounter.load(), numOfTasks);
+  EXPECT_EQ(identifierSum, numOfTasks * (numOfTasks - 1) / 2);
+}
+
+TEST(ThreadPoolTest, CollectSchedulerMetrics) {
+  // Arrange
+  constexpr size_t numThreads = 2;
+  constexpr size_t queueSize = 2;
+  constexpr size_t numOfTasks = 4;
+  threadPool::ThreadPool<numThreads, queueSize> threadPool{};
+  threadPool.turnMetricsOn();
+  TestThreadTask task{nullptr, 13};
+
+  // Act
+  threadPool.scheduleTask({&task, 0, true});
+  threadPool.scheduleTask({&task, 1, true});
+  bool rejected = !threadPool.tryScheduleTask({&task, 2, true});
+  threadPool.getNextDoneTask();
+  threadPool.getNextDoneTask();
+
+  for (size_t i = 0; i < numOfTasks; i++) {
+    threadPool.scheduleTask({&task, i, false});
+  }
+  std::atomic stop{false};
+  threadPool.waitForAllTasks(stop);
+  threadPool::PoolMetrics<numThreads> metrics = threadPool.getMetrics();
+
+  // Assert
+  std::uint64_t tasks = 0;
+  std::uint64_t idleNs = 0;
+  for (const threadPool::WorkerMetrics &worker : metrics._workers) {
+    tasks += worker._tasks;
+    idleNs += worker._idleNs;
+    EXPECT_LE(worker._spuriousWakeups, worker._wakeups);
+  }
+  EXPECT_TRUE(metrics._collected);
+  EXPECT_TRUE(rejected);
+  EXPECT_EQ(tasks, numOfTasks + 2);
+  EXPECT_GT(idleNs, 0);
+  EXPECT_LE(idleNs, numThreads * metrics._uptimeNs);
+  EXPECT_EQ(metrics._rejections, 1);
+  EXPECT_GE(metrics._producerWaits, 1);
+  EXPECT_EQ(metrics._queueDepthSamples, numOfTasks + 2);
+  EXPECT_LE(metrics._maxQueueDepth, queueSize);
+}
+
+TEST(ThreadPoolTest, MetricsAreOffByDefault) {
+  // Arrange
+  threadPool::ThreadPool<2, 10> threadPool{};
+  TestThreadTask task{nullptr, 13};
+
+  // Act
+  threadPool.scheduleTask({&task, 0, false});
+  std::atomic stop{false};
+  threadPool.waitForAllTasks(stop);
+  threadPool::PoolMetrics<2> metrics = threadPool.getMetrics();
+
+  // Assert
+  EXPECT_FALSE(threadPool.areMetricsOn());
+  EXPECT_FALSE(metrics._collected);
+  EXPECT_EQ(metrics._workers[0]._tasks + metrics._workers[1]._tasks, 0);
+  EXPECT_EQ(metrics._workers[0]._wakeups + metrics._workers[1]._wakeups, 0);
+  EXPECT_EQ(metrics._queueDepthSamples, 0);
+}
+
+TEST(ThreadPoolTest, MetricsAreEmptyWithoutInstrumentation) {
+  // Arrange
+  using Job = threadPool::BasicThreadJob<threadPool::NoInstrumentation>;
+  threadPool::ThreadPool<2, 10, Job> threadPool{};
+  threadPool.turnMetricsOn();
+  TestThreadTask task{nullptr, 13};
+
+  // Act
+  threadPool.scheduleTask({&task, 0, false});
+  std::atomic stop{false};
+  threadPool.waitForAllTasks(stop);
+  threadPool::PoolMetrics<2> metrics = threadPool.getMetrics();
+
+  // Assert
+  EXPECT_EQ(metrics._workers[0]._tasks + metrics._workers[1]._tasks, 0);
+  EXPECT_EQ(metrics._uptimeNs, 0);
+  EXPECT_EQ(metrics._queueDepthSamples, 0);
+}
+
 } // namespace baltazar
@@ -2,6 +2,9 @@
 #define BALTAZAR_THREAD_POOL_HPP
 
 #include "../utils/optional.hpp"
+#include "inline_task.hpp"
+#include "instrumentation.hpp"
+#include "pool_metrics.hpp"
 #include "thread_task.hpp"
 #include "thread_task_queue.hpp"
 
@@ -14,14 +17,26 @@
 #include <mutex>
 #include <optional>
 #include <thread>
+#include <type_traits>
 
 namespace baltazar {
 namespace threadPool {
 
-template <size_t THREAD_NUM, size_t MAX_QUEUE_SIZE> class ThreadPool {
+// JOB is either BasicThreadJob, which points to an IThreadTask owned by
+// caller, or InlineThreadJob, which carries its callable by value.
+// INSTRUMENTATION is NoInstrumentation or RuntimeInstrumentation and defaults
+// to the one JOB is laid out for. RuntimeInstrumentation timestamps jobs and
+// can collect scheduler metrics, returned by getMetrics(), once they are
+// turned on with turnMetricsOn().
+template <size_t THREAD_NUM, size_t MAX_QUEUE_SIZE, typename JOB = ThreadJob,
+          typename INSTRUMENTATION = typename JOB::Instrumentation>
+class ThreadPool {
+  static_assert(std::is_same_v<typename JOB::Instrumentation, INSTRUMENTATION>,
+                "Job layout must match instrumentation of the pool.");
+
   std::array<std::thread, THREAD_NUM> m_threads;
-  TaskQueue<MAX_QUEUE_SIZE> m_scheduledJobs;
-  TaskQueue<MAX_QUEUE_SIZE> m_doneJobs;
+  TaskQueue<MAX_QUEUE_SIZE, JOB> m_scheduledJobs;
+  TaskQueue<MAX_QUEUE_SIZE, JOB> m_doneJobs;
   size_t m_numberOfTasks{0};
   size_t m_numberOfRunningTasks{0};
   std::mutex m_mtx;
@@ -30,43 +45,45 @@ template <size_t THREAD_NUM, size_t MAX_QUEUE_SIZE> class ThreadPool {
   std::condition_variable m_popedTaskCv;
   bool m_stop{false};
 
+  std::array<detail::WorkerCounters, THREAD_NUM> m_workerCounters;
+  detail::ProducerCounters m_producerCounters;
+  utils::ProfilingClock::time_point m_createdTimePoint;
+  std::atomic<bool> m_metricsOn{false};
+
 public:
-  explicit ThreadPool() {
+  explicit ThreadPool() : m_createdTimePoint(utils::ProfilingClock::now()) {
     for (int i = 0; i < THREAD_NUM; i++) {
       m_threads[i] = std::thread([this, i] {
         while (true) {
+          const bool collectMetrics = areMetricsOn();
           std::unique_lock lock(m_mtx);
-          m_addTaskCv.wait(
-              lock, [this] { return !m_scheduledJobs.empty() || m_stop; });
+          waitForJob(lock, m_workerCounters[i], collectMetrics);
 
           if (m_stop) {
             break;
           }
 
           auto job = m_scheduledJobs.pop().value();
-          auto task = job._task;
           m_numberOfRunningTasks++;
           lock.unlock();
 
+          if (collectMetrics) {
+            m_workerCounters[i]._tasks.add(1);
+          }
+
 #ifdef DEBUGLOG
           std::cout << "[Thread" << i << "] "
                     << "Thread " << i << " has resources."
                     << "\n";
 
           std::cout << "[Thread" << i << "] "
-                    << "Running a task = " << task->getIdentifier() << "\n";
-#endif
-
-#ifdef PROFILELOG
-          job._startedTimePoint = std::chrono::steady_clock::now();
-          job._threadId = static_cast<size_t>(i);
+                    << "Running a task = " << getThreadJobIdentifier(job)
+                    << "\n";
 #endif
 
-          task->run();
-
-#ifdef PROFILELOG
-          job._endedTimePoint = std::chrono::steady_clock::now();
-#endif
+          stampStarted(job, static_cast<size_t>(i));
+          runThreadJob(job);
+          stampEnded(job);
 
           lock.lock();
           m_numberOfRunningTasks--;
@@ -79,8 +96,8 @@ public:
 
 #ifdef DEBUGLOG
             std::cout << "[Thread" << i << "] "
-                      << "Subbmiting task for sync = " << task->getIdentifier()
-                      << "\n";
+                      << "Subbmiting task for sync = "
+                      << getThreadJobIdentifier(job) << "\n";
 #endif
           } else {
             m_numberOfTasks--;
@@ -92,7 +109,7 @@ public:
 #ifdef DEBUGLOG
             std::cout << "[Thread" << i << "] "
                       << "Discard task after finishing = "
-                      << task->getIdentifier() << "\n";
+                      << getThreadJobIdentifier(job) << "\n";
 #endif
           }
         }
@@ -110,25 +127,27 @@ public:
     }
   }
 
-  bool tryScheduleTask(ThreadJob job) {
+  bool tryScheduleTask(JOB job) {
+    const bool collectMetrics = areMetricsOn();
     std::unique_lock lock(m_mtx);
 
     if (m_numberOfTasks >= MAX_QUEUE_SIZE) {
+      countRejection(collectMetrics);
       return false;
     }
 
-#ifdef PROFILELOG
-    job._scheduledTimePoint = std::chrono::steady_clock::now();
-#endif
+    stampScheduled(job);
 
     if (!m_scheduledJobs.push(job)) {
+      countRejection(collectMetrics);
       return false;
     }
 
     m_numberOfTasks++;
+    sampleQueueDepth(collectMetrics);
 
 #ifdef DEBUGLOG
-    std::cout << "Scheduling task " << job._task->getIdentifier() << "\n";
+    std::cout << "Scheduling task " << getThreadJobIdentifier(job) << "\n";
 #endif
 
     lock.unlock();
@@ -137,28 +156,36 @@ public:
     return true;
   }
 
-  bool scheduleTask(ThreadJob job) {
+  bool scheduleTask(JOB job) {
+    const bool collectMetrics = areMetricsOn();
     std::unique_lock lock(m_mtx);
 
-    m_popedTaskCv.wait(lock, [this] {
+    auto canSchedule = [this] {
       return ((m_numberOfTasks < MAX_QUEUE_SIZE) && !m_scheduledJobs.full()) ||
              m_stop;
-    });
+    };
+    if (collectMetrics && !canSchedule()) {
+      auto waitStart = utils::ProfilingClock::now();
+      m_popedTaskCv.wait(lock, canSchedule);
+      m_producerCounters._waits.add(1);
+      m_producerCounters._waitNs.add(elapsedNs(waitStart));
+    } else {
+      m_popedTaskCv.wait(lock, canSchedule);
+    }
 
     if (m_stop) {
       return false;
     }
 
-#ifdef PROFILELOG
-    job._scheduledTimePoint = std::chrono::steady_clock::now();
-#endif
+    stampScheduled(job);
 
     m_numberOfTasks++;
     bool success = m_scheduledJobs.push(job);
     assert(success && "Fatal error: mutex is locked twice.");
+    sampleQueueDepth(collectMetrics);
 
 #ifdef DEBUGLOG
-    std::cout << "Scheduling task " << job._task->getIdentifier() << "\n";
+    std::cout << "Scheduling task " << getThreadJobIdentifier(job) << "\n";
 #endif
 
     lock.unlock();
@@ -167,20 +194,21 @@ public:
     return true;
   }
 
-  utils::Optional<ThreadJob> tryGetNextDoneTask() {
+  utils::Optional<JOB> tryGetNextDoneTask() {
     std::unique_lock lock(m_mtx);
 
     if (m_doneJobs.empty()) {
-      return utils::Optional<ThreadJob>();
+      return utils::Optional<JOB>();
     }
 
     m_numberOfTasks--;
-    ThreadJob job = m_doneJobs.pop().value();
-    assert(job._task != nullptr &&
+    JOB job = m_doneJobs.pop().value();
+    assert(isThreadJobValid(job) &&
            "Fatal error: Null pointer pushed to done tasks.");
 
 #ifdef DEBUGLOG
-    std::cout << "Reporting done task " << job._task->getIdentifier() << "\n";
+    std::cout << "Reporting done task " << getThreadJobIdentifier(job)
+              << "\n";
 #endif
 
     lock.unlock();
@@ -189,22 +217,23 @@ public:
     return job;
   }
 
-  utils::Optional<ThreadJob> getNextDoneTask() {
+  utils::Optional<JOB> getNextDoneTask() {
     std::unique_lock lock(m_mtx);
 
     m_finishTaskCv.wait(lock, [this] { return !m_doneJobs.empty() || m_stop; });
 
     if (m_stop) {
-      return utils::Optional<ThreadJob>();
+      return utils::Optional<JOB>();
     }
 
     m_numberOfTasks--;
-    ThreadJob job = m_doneJobs.pop().value();
-    assert(job._task != nullptr &&
+    JOB job = m_doneJobs.pop().value();
+    assert(isThreadJobValid(job) &&
            "Fatal error: Null pointer pushed to done tasks.");
 
 #ifdef DEBUGLOG
-    std::cout << "Reporting done task " << job._task->getIdentifier() << "\n";
+    std::cout << "Reporting done task " << getThreadJobIdentifier(job)
+              << "\n";
 #endif
 
     lock.unlock();
@@ -234,6 +263,128 @@ public:
     lock.unlock();
     m_addTaskCv.notify_all();
   }
+
+  // Metrics are off by default, so pools that don't read them skip the clock
+  // reads and counters. Turning them on calibrates the profiling clock, which
+  // can block for a few milliseconds the first time. Does nothing with
+  // NoInstrumentation.
+  void turnMetricsOn() {
+    if constexpr (INSTRUMENTATION::enabled) {
+      utils::ProfilingClock::calibrate();
+      m_metricsOn.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  void turnMetricsOff() { m_metricsOn.store(false, std::memory_order_relaxed); }
+
+  bool areMetricsOn() const {
+    if constexpr (INSTRUMENTATION::enabled) {
+      return m_metricsOn.load(std::memory_order_relaxed);
+    } else {
+      return false;
+    }
+  }
+
+  // Snapshot of scheduler metrics, counted only while they are on and all
+  // zeros with NoInstrumentation. Can be called from any thread while the
+  // pool is running.
+  PoolMetrics<THREAD_NUM> getMetrics() const {
+    PoolMetrics<THREAD_NUM> metrics{};
+    if constexpr (INSTRUMENTATION::enabled) {
+      for (size_t i = 0; i < THREAD_NUM; i++) {
+        const detail::WorkerCounters &counters = m_workerCounters[i];
+        metrics._workers[i] = {
+            counters._idleNs.get(), counters._wakeups.get(),
+            counters._spuriousWakeups.get(), counters._tasks.get()};
+      }
+      metrics._uptimeNs = elapsedNs(m_createdTimePoint);
+      metrics._producerWaits = m_producerCounters._waits.get();
+      metrics._producerWaitNs = m_producerCounters._waitNs.get();
+      metrics._rejections = m_producerCounters._rejections.get();
+      metrics._queueDepthSamples = m_producerCounters._queueDepthSamples.get();
+      metrics._queueDepthSum = m_producerCounters._queueDepthSum.get();
+      metrics._maxQueueDepth = m_producerCounters._maxQueueDepth.get();
+      metrics._collected = areMetricsOn();
+    }
+    return metrics;
+  }
+
+private:
+  // With metrics, waits without a predicate, so that wake-ups which find
+  // nothing to do can be counted.
+  void waitForJob(std::unique_lock<std::mutex> &lock,
+                  detail::WorkerCounters &counters, bool collectMetrics) {
+    auto hasJob = [this] { return !m_scheduledJobs.empty() || m_stop; };
+    if (!collectMetrics) {
+      m_addTaskCv.wait(lock, hasJob);
+      return;
+    }
+
+    if (hasJob()) {
+      return;
+    }
+
+    auto idleStart = utils::ProfilingClock::now();
+    do {
+      m_addTaskCv.wait(lock);
+      counters._wakeups.add(1);
+      if (!hasJob()) {
+        counters._spuriousWakeups.add(1);
+      }
+    } while (!hasJob());
+    counters._idleNs.add(elapsedNs(idleStart));
+  }
+
+  // Called with the mutex held.
+  void countRejection(bool collectMetrics) {
+    if (collectMetrics) {
+      m_producerCounters._rejections.add(1);
+    }
+  }
+
+  // Called with the mutex held.
+  void sampleQueueDepth(bool collectMetrics) {
+    if (collectMetrics) {
+      auto depth = static_cast<std::uint64_t>(m_scheduledJobs.size());
+      m_producerCounters._queueDepthSamples.add(1);
+      m_producerCounters._queueDepthSum.add(depth);
+      m_producerCounters._maxQueueDepth.max(depth);
+    }
+  }
+
+  static std::uint64_t elapsedNs(utils::ProfilingClock::time_point start) {
+    auto ns =
+        utils::ProfilingClock::elapsed(start, utils::ProfilingClock::now())
+            .count();
+    return ns < 0 ? 0U : static_cast<std::uint64_t>(ns);
+  }
+
+  // Timestamps are only accessed with instrumentation, so jobs of
+  // NoInstrumentation pools don't need to carry them.
+  static void stampScheduled(JOB &job) {
+    if constexpr (INSTRUMENTATION::enabled) {
+      if (job._profiled) {
+        job._scheduledTimePoint = utils::ProfilingClock::now();
+      }
+    }
+  }
+
+  static void stampStarted(JOB &job, size_t threadId) {
+    if constexpr (INSTRUMENTATION::enabled) {
+      if (job._profiled) {
+        job._startedTimePoint = utils::ProfilingClock::now();
+        job._threadId = threadId;
+      }
+    }
+  }
+
+  static void stampEnded(JOB &job) {
+    if constexpr (INSTRUMENTATION::enabled) {
+      if (job._profiled) {
+        job._endedTimePoint = utils::ProfilingClock::now();
+      }
+    }
+  }
 };
 } // namespace threadPool
 } // namespace baltazar
@@ -1,6 +1,9 @@
 #ifndef BALTAZAR_THREAD_TASK_HPP
 #define BALTAZAR_THREAD_TASK_HPP
 
+#include "../utils/clock.hpp"
+#include "instrumentation.hpp"
+
 #include <chrono>
 #include <cstddef>
 
@@ -25,19 +28,58 @@ public:
   size_t getIdentifier() const override { return 0UL; }
 };
 
-struct ThreadJob {
+// Thread id of jobs run on the coordinating thread, e.g. by SerialCoreRunner.
+// Fits the 32 bit thread id of binary traces.
+constexpr size_t coordinatorThreadId = 0xFFFFFFFFUL;
+
+// Job pointing to an IThreadTask owned by caller. Timestamps are only part
+// of the layout with RuntimeInstrumentation, so jobs of uninstrumented pools
+// stay three fields wide.
+template <typename INSTRUMENTATION> struct BasicThreadJob {
+  using Instrumentation = INSTRUMENTATION;
+
+  IThreadTask *_task;
+  size_t _id;
+  bool _shouldSyncWhenDone;
+};
+
+// Timestamps and thread id are only filled for jobs with _profiled set. They
+// are default initialized, so jobs can be built from the first three fields.
+template <> struct BasicThreadJob<RuntimeInstrumentation> {
+  using Instrumentation = RuntimeInstrumentation;
+
   IThreadTask *_task;
   size_t _id;
   bool _shouldSyncWhenDone;
-#ifdef PROFILELOG
-  std::chrono::steady_clock::time_point _scheduledTimePoint;
-  std::chrono::steady_clock::time_point _startedTimePoint;
-  std::chrono::steady_clock::time_point _endedTimePoint;
-  std::chrono::steady_clock::time_point _syncedTimePoint;
-  size_t _threadId;
-#endif
+  bool _profiled{false};
+  utils::ProfilingClock::time_point _scheduledTimePoint{};
+  utils::ProfilingClock::time_point _startedTimePoint{};
+  utils::ProfilingClock::time_point _endedTimePoint{};
+  utils::ProfilingClock::time_point _syncedTimePoint{};
+  size_t _threadId{0};
 };
 
+using ThreadJob = BasicThreadJob<RuntimeInstrumentation>;
+
+static_assert(sizeof(BasicThreadJob<NoInstrumentation>) <= 3 * sizeof(void *),
+              "Uninstrumented job must not carry timestamps.");
+
+template <typename INSTRUMENTATION>
+inline void runThreadJob(const BasicThreadJob<INSTRUMENTATION> &job) {
+  job._task->run();
+}
+
+template <typename INSTRUMENTATION>
+inline size_t
+getThreadJobIdentifier(const BasicThreadJob<INSTRUMENTATION> &job) {
+  return job._task->getIdentifier();
+}
+
+template <typename INSTRUMENTATION>
+inline bool isThreadJobValid(const BasicThreadJob<INSTRUMENTATION> &job) {
+  return job._task != nullptr;
+}
+
 const NullThreadTask nullThreadTask{};
 
 } // namespace threadPool
@@ -9,8 +9,8 @@
 
 namespace baltazar {
 namespace threadPool {
-template <size_t MAX_TASKS> class TaskQueue {
-  std::array<ThreadJob, MAX_TASKS> m_tasks{};
+template <size_t MAX_TASKS, typename JOB = ThreadJob> class TaskQueue {
+  std::array<JOB, MAX_TASKS> m_tasks{};
   size_t m_head = 0UL;
   size_t m_tail = 0UL;
   size_t m_size = 0UL;
@@ -18,7 +18,7 @@ template <size_t MAX_TASKS> class TaskQueue {
 public:
   TaskQueue() = default;
 
-  [[nodiscard]] bool push(const ThreadJob task) {
+  [[nodiscard]] bool push(const JOB task) {
     if (m_size >= MAX_TASKS) {
       return false;
     }
@@ -29,12 +29,12 @@ public:
     return true;
   }
 
-  const utils::Optional<ThreadJob> pop() { // NOLINT
+  const utils::Optional<JOB> pop() { // NOLINT
     if (m_size <= 0UL) {
-      return utils::Optional<ThreadJob>();
+      return utils::Optional<JOB>();
     }
 
-    ThreadJob out = m_tasks[m_head];
+    JOB out = m_tasks[m_head];
     m_head = (m_head + 1UL) % MAX_TASKS;
     m_size--;
     return out;
@@ -0,0 +1,118 @@
+#ifndef BALTAZAR_ARENA_HPP
+#define BALTAZAR_ARENA_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace baltazar {
+namespace utils {
+
+// Bump allocator over a few large blocks. Objects are never freed one by one,
+// non-trivial destructors run in reverse creation order when arena is
+// destroyed.
+class Arena {
+public:
+  static constexpr size_t defaultBlockSize = 64UL * 1024UL;
+
+  explicit Arena(size_t blockSize = defaultBlockSize)
+      : m_blockSize(blockSize) {}
+
+  Arena(const Arena &other) = delete;
+  Arena(Arena &&other) = delete;
+  Arena &operator=(const Arena &other) = delete;
+  Arena &operator=(Arena &&other) = delete;
+
+  ~Arena() {
+    while (m_destructors != nullptr) {
+      m_destructors->_destroy(m_destructors->_object);
+      m_destructors = m_destructors->_next;
+    }
+  }
+
+  void *allocate(size_t size, size_t alignment) {
+    assert((alignment & (alignment - 1UL)) == 0UL &&
+           "Alignment must be a power of two!");
+
+    size_t padding = paddingFor(m_current, alignment);
+    if (m_current == nullptr || padding + size > m_remaining) {
+      addBlock(size + alignment);
+      padding = paddingFor(m_current, alignment);
+    }
+
+    unsigned char *out = m_current + padding;
+    m_current = out + size;
+    m_remaining -= padding + size;
+    m_usedBytes += size;
+    return out;
+  }
+
+  template <typename T, typename... ARGS> T *create(ARGS &&...args) {
+    void *memory = allocate(sizeof(T), alignof(T));
+    T *object = new (memory) T(std::forward<ARGS>(args)...);
+
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      auto *destructor = static_cast<Destructor *>(
+          allocate(sizeof(Destructor), alignof(Destructor)));
+      destructor->_destroy = [](void *ptr) { static_cast<T *>(ptr)->~T(); };
+      destructor->_object = object;
+      destructor->_next = m_destructors;
+      m_destructors = destructor;
+    }
+
+    return object;
+  }
+
+  // Value initialized array of trivially destructible elements.
+  template <typename T> T *allocateArray(size_t count) {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "Arena arrays must be trivially destructible.");
+
+    if (count == 0UL) {
+      return nullptr;
+    }
+
+    void *memory = allocate(sizeof(T) * count, alignof(T));
+    return new (memory) T[count]();
+  }
+
+  size_t getNumberOfBlocks() const { return m_blocks.size(); }
+
+  size_t getUsedBytes() const { return m_usedBytes; }
+
+private:
+  struct Destructor {
+    void (*_destroy)(void *);
+    void *_object;
+    Destructor *_next;
+  };
+
+  static size_t paddingFor(const unsigned char *ptr, size_t alignment) {
+    auto address = reinterpret_cast<std::uintptr_t>(ptr);
+    return (alignment - (address & (alignment - 1UL))) & (alignment - 1UL);
+  }
+
+  void addBlock(size_t minimalSize) {
+    size_t size = minimalSize > m_blockSize ? minimalSize : m_blockSize;
+    m_blocks.emplace_back(new unsigned char[size]);
+    m_current = m_blocks.back().get();
+    m_remaining = size;
+  }
+
+  std::vector<std::unique_ptr<unsigned char[]>> m_blocks;
+  unsigned char *m_current{nullptr};
+  size_t m_remaining{0UL};
+  size_t m_usedBytes{0UL};
+  size_t m_blockSize;
+  Destructor *m_destructors{nullptr};
+};
+
+} // namespace utils
+} // namespace baltazar
+
+#endif // BALTAZAR_ARENA_HPP
@@ -0,0 +1,142 @@
+#ifndef BALTAZAR_CLOCK_HPP
+#define BALTAZAR_CLOCK_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define BALTAZAR_HAS_TSC 1
+#endif
+
+namespace baltazar {
+namespace utils {
+
+// Clocks used for profiling timestamps. Time points are cheap to take and are
+// converted to nanoseconds on steady_clock's epoch only when they are written
+// out or subtracted.
+struct SteadyClock {
+  using time_point = std::chrono::steady_clock::time_point;
+
+  static time_point now() { return std::chrono::steady_clock::now(); }
+
+  static std::int64_t toNanoseconds(time_point tp) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               tp.time_since_epoch())
+        .count();
+  }
+
+  static std::chrono::nanoseconds elapsed(time_point start, time_point end) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+  }
+
+  static void calibrate() {}
+};
+
+#ifdef BALTAZAR_HAS_TSC
+
+// Reads time stamp counter directly. Counter is calibrated once against
+// steady_clock, which blocks for about 10ms, so it should be triggered with
+// calibrate() before timing anything. Otherwise it happens on first
+// conversion. Without invariant TSC, ticks silently fall back to steady_clock
+// nanoseconds.
+class TscClock {
+public:
+  struct time_point {
+    std::uint64_t _ticks;
+  };
+
+  static time_point now() {
+    if (hasInvariantTsc) {
+      return {__rdtsc()};
+    }
+    return {static_cast<std::uint64_t>(
+        SteadyClock::toNanoseconds(SteadyClock::now()))};
+  }
+
+  static std::int64_t toNanoseconds(time_point tp) {
+    const Calibration &calibration = getCalibration();
+    auto ticks = static_cast<std::int64_t>(tp._ticks - calibration._ticks);
+    return calibration._ns + static_cast<std::int64_t>(
+                                 static_cast<double>(ticks) *
+                                 calibration._nsPerTick);
+  }
+
+  static std::chrono::nanoseconds elapsed(time_point start, time_point end) {
+    auto ticks = static_cast<std::int64_t>(end._ticks - start._ticks);
+    return std::chrono::nanoseconds{static_cast<std::int64_t>(
+        static_cast<double>(ticks) * getCalibration()._nsPerTick)};
+  }
+
+  static void calibrate() { getCalibration(); }
+
+  static double getNanosecondsPerTick() {
+    return getCalibration()._nsPerTick;
+  }
+
+  // CPUID leaf 0x80000007, EDX bit 8.
+  static bool detectInvariantTsc() {
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    if (__get_cpuid(0x80000000U, &eax, &ebx, &ecx, &edx) == 0 ||
+        eax < 0x80000007U) {
+      return false;
+    }
+    __get_cpuid(0x80000007U, &eax, &ebx, &ecx, &edx);
+    return (edx & (1U << 8U)) != 0U;
+  }
+
+  static inline const bool hasInvariantTsc = detectInvariantTsc();
+
+private:
+  struct Calibration {
+    std::uint64_t _ticks;
+    std::int64_t _ns;
+    double _nsPerTick;
+  };
+
+  static const Calibration &getCalibration() {
+    static const Calibration calibration = measureCalibration();
+    return calibration;
+  }
+
+  static Calibration measureCalibration() {
+    if (!hasInvariantTsc) {
+      return {0U, 0, 1.0};
+    }
+
+    constexpr auto calibrationTime = std::chrono::milliseconds(10);
+    auto startNs = SteadyClock::toNanoseconds(SteadyClock::now());
+    std::uint64_t startTicks = __rdtsc();
+    std::this_thread::sleep_for(calibrationTime);
+    auto endNs = SteadyClock::toNanoseconds(SteadyClock::now());
+    std::uint64_t endTicks = __rdtsc();
+
+    double nsPerTick = static_cast<double>(endNs - startNs) /
+                       static_cast<double>(endTicks - startTicks);
+    return {endTicks, endNs, nsPerTick};
+  }
+};
+
+#endif // BALTAZAR_HAS_TSC
+
+#if defined(BALTAZAR_TSC_CLOCK) && defined(BALTAZAR_HAS_TSC)
+using ProfilingClock = TscClock;
+#else
+using ProfilingClock = SteadyClock;
+#endif
+
+template <typename DURATION, typename CLOCK = ProfilingClock>
+DURATION elapsed(typename CLOCK::time_point start,
+                 typename CLOCK::time_point end) {
+  return std::chrono::duration_cast<DURATION>(CLOCK::elapsed(start, end));
+}
+
+} // namespace utils
+} // namespace baltazar
+
+#endif // BALTAZAR_CLOCK_HPP
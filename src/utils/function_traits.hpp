@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <tuple>
+#include <utility>
 
 namespace baltazar {
 namespace utils {
@@ -36,6 +37,12 @@ struct FunctionTraits<RET_TYPE (CLASS::*)(ARGS...)>
 template <typename F>
 struct FunctionTraits : FunctionTraits<decltype(&F::operator())> {};
 
+// Tuple of first elements selected by index sequence, only used in
+// unevaluated context.
+template <typename TUPLE, size_t... Is>
+std::tuple<std::tuple_element_t<Is, TUPLE>...>
+tupleHead(std::index_sequence<Is...>);
+
 } // namespace utils
 } // namespace baltazar
 
@@ -0,0 +1,123 @@
+#ifndef BALTAZAR_LOG_LINEAR_HISTOGRAM_HPP
+#define BALTAZAR_LOG_LINEAR_HISTOGRAM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace baltazar {
+namespace utils {
+
+inline size_t mostSignificantBit(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63UL - static_cast<size_t>(__builtin_clzll(value));
+#else
+  size_t msb = 0;
+  while (value >>= 1U) {
+    msb++;
+  }
+  return msb;
+#endif
+}
+
+// Fixed memory HDR-style histogram. Values below 2^SUB_BUCKET_BITS are exact,
+// every following power of two range is split into 2^SUB_BUCKET_BITS linear
+// buckets, which bounds relative error by 2^-SUB_BUCKET_BITS. Values above
+// 2^MAX_VALUE_BITS - 1 are clamped into the last bucket.
+template <size_t SUB_BUCKET_BITS = 5, size_t MAX_VALUE_BITS = 40>
+class LogLinearHistogram {
+  static_assert(SUB_BUCKET_BITS > 0 && SUB_BUCKET_BITS < MAX_VALUE_BITS &&
+                    MAX_VALUE_BITS < 64,
+                "Invalid histogram bucket configuration.");
+
+public:
+  static constexpr size_t subBucketCount = 1UL << SUB_BUCKET_BITS;
+  static constexpr size_t numberOfBuckets =
+      (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * subBucketCount;
+  static constexpr std::uint64_t maxTrackableValue =
+      (std::uint64_t{1} << MAX_VALUE_BITS) - 1U;
+
+  void record(std::uint64_t value) {
+    m_counts[bucketIndex(value)]++;
+    m_count++;
+    m_max = value > m_max ? value : m_max;
+    m_min = value < m_min ? value : m_min;
+  }
+
+  // Percentile in range [0, 100]. Returns highest value equivalent to the
+  // bucket holding the percentile, never more than the recorded maximum.
+  std::uint64_t valueAtPercentile(double percentile) const {
+    if (m_count == 0) {
+      return 0;
+    }
+
+    auto target = static_cast<std::uint64_t>(
+        percentile / 100.0 * static_cast<double>(m_count) + 0.5);
+    target = target == 0 ? 1 : target;
+
+    std::uint64_t cumulative = 0;
+    for (size_t i = 0; i < numberOfBuckets; i++) {
+      cumulative += m_counts[i];
+      if (cumulative >= target) {
+        std::uint64_t upper = bucketUpperBound(i);
+        return upper < m_max ? upper : m_max;
+      }
+    }
+
+    return m_max;
+  }
+
+  void merge(const LogLinearHistogram &other) {
+    for (size_t i = 0; i < numberOfBuckets; i++) {
+      m_counts[i] += other.m_counts[i];
+    }
+    m_count += other.m_count;
+    m_max = other.m_max > m_max ? other.m_max : m_max;
+    m_min = other.m_min < m_min ? other.m_min : m_min;
+  }
+
+  void reset() {
+    m_counts.fill(0);
+    m_count = 0;
+    m_max = 0;
+    m_min = UINT64_MAX;
+  }
+
+  std::uint64_t getCount() const { return m_count; }
+
+  std::uint64_t getMax() const { return m_max; }
+
+  std::uint64_t getMin() const { return m_count == 0 ? 0 : m_min; }
+
+  static size_t bucketIndex(std::uint64_t value) {
+    value = value > maxTrackableValue ? maxTrackableValue : value;
+    if (value < subBucketCount) {
+      return static_cast<size_t>(value);
+    }
+
+    size_t shift = mostSignificantBit(value) - SUB_BUCKET_BITS;
+    auto mantissa = static_cast<size_t>(value >> shift);
+    return (shift + 1) * subBucketCount + mantissa - subBucketCount;
+  }
+
+  static std::uint64_t bucketUpperBound(size_t index) {
+    if (index < subBucketCount) {
+      return index;
+    }
+
+    size_t shift = (index >> SUB_BUCKET_BITS) - 1;
+    std::uint64_t mantissa = subBucketCount + (index & (subBucketCount - 1));
+    return ((mantissa + 1) << shift) - 1;
+  }
+
+private:
+  std::array<std::uint64_t, numberOfBuckets> m_counts{};
+  std::uint64_t m_count{0};
+  std::uint64_t m_max{0};
+  std::uint64_t m_min{UINT64_MAX};
+};
+
+} // namespace utils
+} // namespace baltazar
+
+#endif // BALTAZAR_LOG_LINEAR_HISTOGRAM_HPP
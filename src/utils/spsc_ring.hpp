@@ -0,0 +1,92 @@
+#ifndef BALTAZAR_SPSC_RING_HPP
+#define BALTAZAR_SPSC_RING_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace baltazar {
+namespace utils {
+
+constexpr size_t cacheLineSize = 64UL;
+
+// Wait-free single producer single consumer ring. Producer and consumer
+// indices live on separate cache lines and each side caches the other's index,
+// so the shared lines are only touched when the cached view runs out.
+template <typename T, size_t CAPACITY> class SpscRing {
+  static_assert(CAPACITY > 0UL && (CAPACITY & (CAPACITY - 1UL)) == 0UL,
+                "Capacity must be a power of two.");
+
+public:
+  SpscRing() = default;
+
+  SpscRing(const SpscRing &other) = delete;
+  SpscRing(SpscRing &&other) = delete;
+  SpscRing &operator=(const SpscRing &other) = delete;
+  SpscRing &operator=(SpscRing &&other) = delete;
+
+  ~SpscRing() = default;
+
+  // Producer side.
+  [[nodiscard]] bool tryPush(const T &value) {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_cachedTail >= CAPACITY) {
+      m_cachedTail = m_tail.load(std::memory_order_acquire);
+      if (head - m_cachedTail >= CAPACITY) {
+        return false;
+      }
+    }
+
+    m_items[head & mask] = value;
+    m_head.store(head + 1UL, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Visits up to maxCount items in place and releases their
+  // slots in one store. Returns number of visited items.
+  template <typename VISITOR>
+  size_t consume(VISITOR &&visitor, size_t maxCount) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (m_cachedHead == tail) {
+      m_cachedHead = m_head.load(std::memory_order_acquire);
+    }
+
+    size_t available = m_cachedHead - tail;
+    size_t count = available < maxCount ? available : maxCount;
+    for (size_t i = 0; i < count; i++) {
+      visitor(m_items[(tail + i) & mask]);
+    }
+
+    m_tail.store(tail + count, std::memory_order_release);
+    return count;
+  }
+
+  // Consumer side.
+  [[nodiscard]] bool tryPop(T &out) {
+    return consume([&out](const T &value) { out = value; }, 1UL) == 1UL;
+  }
+
+  // Approximate when called concurrently with producer or consumer.
+  size_t size() const {
+    return m_head.load(std::memory_order_acquire) -
+           m_tail.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] bool empty() const { return size() == 0UL; }
+
+  static constexpr size_t capacity() { return CAPACITY; }
+
+private:
+  static constexpr size_t mask = CAPACITY - 1UL;
+
+  alignas(cacheLineSize) std::atomic<size_t> m_head{0UL};
+  size_t m_cachedTail{0UL};
+  alignas(cacheLineSize) std::atomic<size_t> m_tail{0UL};
+  size_t m_cachedHead{0UL};
+  alignas(cacheLineSize) std::array<T, CAPACITY> m_items{};
+};
+
+} // namespace utils
+} // namespace baltazar
+
+#endif // BALTAZAR_SPSC_RING_HPP
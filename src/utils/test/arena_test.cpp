@@ -0,0 +1,67 @@
+#include "../arena.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+
+namespace baltazar {
+
+class DestructorCounter {
+public:
+  explicit DestructorCounter(size_t *counter) : m_counter(counter) {}
+
+  ~DestructorCounter() { ++*m_counter; }
+
+private:
+  size_t *m_counter;
+};
+
+TEST(ArenaTest, AllocationsAreAlignedAndShareOneBlock) {
+  // Arrange
+  utils::Arena arena{1024};
+
+  // Act
+  auto *a = arena.create<char>('a');
+  auto *b = arena.create<double>(2.0);
+  auto *c = arena.allocateArray<std::uint64_t>(4);
+
+  // Assert
+  EXPECT_EQ(*a, 'a');
+  EXPECT_EQ(*b, 2.0);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % alignof(double), 0);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c) % alignof(std::uint64_t), 0);
+  EXPECT_EQ(c[3], 0);
+  EXPECT_EQ(arena.getNumberOfBlocks(), 1);
+}
+
+TEST(ArenaTest, LargeAllocationGetsItsOwnBlock) {
+  // Arrange
+  utils::Arena arena{64};
+
+  // Act
+  auto *values = arena.allocateArray<int>(1000);
+  values[999] = 3;
+
+  // Assert
+  EXPECT_EQ(values[999], 3);
+  EXPECT_EQ(arena.getNumberOfBlocks(), 1);
+  EXPECT_GE(arena.getUsedBytes(), 1000 * sizeof(int));
+}
+
+TEST(ArenaTest, DestructorsRunWhenArenaIsDestroyed) {
+  // Arrange
+  size_t counter = 0;
+
+  // Act
+  {
+    utils::Arena arena{};
+    arena.create<DestructorCounter>(&counter);
+    arena.create<DestructorCounter>(&counter);
+    arena.create<std::string>(100, 'x');
+  }
+
+  // Assert
+  EXPECT_EQ(counter, 2);
+}
+
+} // namespace baltazar
@@ -0,0 +1,49 @@
+#include "../clock.hpp"
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace baltazar {
+
+TEST(ClockTest, SteadyClockElapsedMatchesSleep) {
+  // Arrange
+  auto start = utils::SteadyClock::now();
+
+  // Act
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  auto end = utils::SteadyClock::now();
+  auto elapsed = utils::elapsed<std::chrono::microseconds, utils::SteadyClock>(
+      start, end);
+
+  // Assert
+  EXPECT_GE(elapsed.count(), 2000);
+}
+
+#ifdef BALTAZAR_HAS_TSC
+TEST(ClockTest, TscClockConvertsToSteadyNanoseconds) {
+  // Arrange
+  auto steadyBefore =
+      utils::SteadyClock::toNanoseconds(utils::SteadyClock::now());
+  auto start = utils::TscClock::now();
+
+  // Act
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  auto end = utils::TscClock::now();
+  auto steadyAfter =
+      utils::SteadyClock::toNanoseconds(utils::SteadyClock::now());
+  auto elapsed = utils::TscClock::elapsed(start, end).count();
+  auto startNs = utils::TscClock::toNanoseconds(start);
+  auto endNs = utils::TscClock::toNanoseconds(end);
+
+  // Assert
+  EXPECT_GE(elapsed, 4500000);
+  EXPECT_LE(elapsed, steadyAfter - steadyBefore + 500000);
+  EXPECT_NEAR(static_cast<double>(startNs), static_cast<double>(steadyBefore),
+              500000.0);
+  EXPECT_NEAR(static_cast<double>(endNs), static_cast<double>(steadyAfter),
+              500000.0);
+}
+#endif
+
+} // namespace baltazar
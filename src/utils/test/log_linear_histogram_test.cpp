@@ -0,0 +1,52 @@
+#include "../log_linear_histogram.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+
+namespace baltazar {
+
+TEST(LogLinearHistogramTest, BucketsBoundRelativeError) {
+  // Arrange
+  using Histogram = utils::LogLinearHistogram<5, 40>;
+  bool withinError = true;
+  bool monotonic = true;
+  size_t lastIndex = 0;
+
+  // Act
+  for (std::uint64_t value = 1; value < (1ULL << 30); value = value * 3 + 1) {
+    size_t index = Histogram::bucketIndex(value);
+    std::uint64_t upper = Histogram::bucketUpperBound(index);
+    withinError = withinError && upper >= value &&
+                  static_cast<double>(upper - value) <=
+                      static_cast<double>(value) / Histogram::subBucketCount;
+    monotonic = monotonic && index >= lastIndex;
+    lastIndex = index;
+  }
+
+  // Assert
+  EXPECT_TRUE(withinError);
+  EXPECT_TRUE(monotonic);
+  EXPECT_EQ(Histogram::bucketIndex(UINT64_MAX), Histogram::numberOfBuckets - 1);
+}
+
+TEST(LogLinearHistogramTest, PercentilesFollowRecordedValues) {
+  // Arrange
+  utils::LogLinearHistogram<5, 40> histogram{};
+
+  // Act
+  for (std::uint64_t value = 1; value <= 1000; value++) {
+    histogram.record(value * 1000);
+  }
+  std::uint64_t p50 = histogram.valueAtPercentile(50.0);
+  std::uint64_t p99 = histogram.valueAtPercentile(99.0);
+  std::uint64_t p100 = histogram.valueAtPercentile(100.0);
+
+  // Assert
+  EXPECT_EQ(histogram.getCount(), 1000);
+  EXPECT_EQ(histogram.getMin(), 1000);
+  EXPECT_NEAR(static_cast<double>(p50), 500000.0, 500000.0 / 32.0);
+  EXPECT_NEAR(static_cast<double>(p99), 990000.0, 990000.0 / 32.0);
+  EXPECT_EQ(p100, 1000000);
+}
+
+} // namespace baltazar
@@ -0,0 +1,63 @@
+#include "../spsc_ring.hpp"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace baltazar {
+
+TEST(SpscRingTest, PushFailsWhenFullAndPopKeepsOrder) {
+  // Arrange
+  utils::SpscRing<int, 4> ring{};
+
+  // Act
+  bool pushed = true;
+  for (int i = 0; i < 4; i++) {
+    pushed = pushed && ring.tryPush(i);
+  }
+  bool overflowPushed = ring.tryPush(4);
+
+  int first = -1;
+  bool popped = ring.tryPop(first);
+
+  // Assert
+  EXPECT_TRUE(pushed);
+  EXPECT_FALSE(overflowPushed);
+  EXPECT_TRUE(popped);
+  EXPECT_EQ(first, 0);
+  EXPECT_EQ(ring.size(), 3);
+}
+
+TEST(SpscRingTest, ConsumerSeesEveryItemFromProducerThread) {
+  // Arrange
+  constexpr size_t numberOfItems = 100000UL;
+  utils::SpscRing<size_t, 64> ring{};
+  size_t consumed = 0UL;
+  size_t sum = 0UL;
+  bool ordered = true;
+
+  // Act
+  std::thread producer([&ring]() {
+    for (size_t i = 0; i < numberOfItems; i++) {
+      while (!ring.tryPush(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  while (consumed < numberOfItems) {
+    consumed += ring.consume(
+        [&](size_t value) {
+          ordered = ordered && value == consumed;
+          sum += value;
+        },
+        1UL);
+  }
+  producer.join();
+
+  // Assert
+  EXPECT_TRUE(ordered);
+  EXPECT_EQ(sum, numberOfItems * (numberOfItems - 1UL) / 2UL);
+  EXPECT_TRUE(ring.empty());
+}
+
+} // namespace baltazar